@@ -15,18 +15,70 @@ In case of multiple connected components or the graph is directed and not strong
 
 Observations:
     Good for finding minimal paths between nodes in graphs where each edge has weight 1.
+
+    Keeping, for each node, the node it was added from(it's parent) and it's depth(the parent's depth + 1) gives a shortest path tree from the starting node.
+
+    BFS visits the graph level by level: all nodes at depth d are in the queue before any node at depth d+1.
+    So each level(the frontier) can be processed as a whole, which allows processing it in parallel:
+        The nodes of the frontier are split among threads, and each thread adds the non-visited adjacencies of it's nodes to the next frontier.
+        Two threads may find the same node at once, so a node is claimed by atomically setting it's parent only if it's still unset(compare and swap).
+
+Direction-optimizing BFS:
+    The usual step(top-down) goes from each node in the frontier to it's adjacencies, checking every edge leaving the frontier.
+    On graphs with small diameter, like social networks, a few middle levels contain most of the graph.
+    In these levels, almost every edge checked leads to an already visited node, so most of the work is wasted.
+
+    The bottom-up step does the opposite: each non-visited node looks for a parent among it's incoming adjacencies, and stops at the first one in the frontier.
+    When the frontier is large, a parent is usually found after a few edges, so most edges are never checked.
+    When the frontier is small, most non-visited nodes check all of their edges and find no parent, so top-down is better.
+
+    The algorithm picks a step for each level, by comparing the edges each would check:
+        mf: edges leaving the frontier, checked by a top-down step.
+        mu: edges leaving non-visited nodes, an upper bound of the ones checked by a bottom-up step.
+        Switch from top-down to bottom-up when mf > mu/alpha, i.e, the frontier has grown large.
+        Switch back when the frontier has less than n/beta nodes and is shrinking.
+    alpha = 15 and beta = 18 are the values suggested by Beamer et al.
+
+    Top-down steps keep the frontier as a list of nodes(a queue where each level is a window, sliding to the next level).
+    Bottom-up steps need to test if a node is in the frontier, so the frontier is a bitmap, with one bit per node.
+    Each thread processes a range of nodes that's a multiple of 64, so no two threads write to the same word of the next bitmap.
+
+    Starting and joining a thread takes tens of microseconds, which is more than a small level takes to process.
+    Graphs with a large diameter(e.g, grids and road networks) have thousands of small levels, so each level only uses as many threads as give each of them BFS_PARALLEL_EDGES edges to check.
+    The cutoff counts edges, as a level's work is the edges it checks, unlike the cutoffs in nodes of delta stepping and parallel scc, and in elements of the sparse table's build.
+
+    For a directed graph, bottom-up steps need the incoming adjacencies, which are the adjacencies of the transposed graph.
+
+Multi-source BFS(MS-BFS):
+    Running a bfs from each of k sources checks every edge k times, even though the bfs's often reach a node through the same edges.
+    MS-BFS runs up to 64(or 256) bfs's at once, storing for each node a bitset with one bit per source:
+        seen[v]: the sources that have already reached v.
+        visit[v]: the sources whose frontier contains v.
+        visitNext[v]: the sources whose next frontier contains v.
+    Each level, every node v with some bit in visit[v] passes all of them to it's adjacencies at once, with a single or per edge: visitNext[u] |= visit[v].
+    Then, for each node u, the sources that reach it for the first time are visitNext[u] & ~seen[u], and their distance to u is the current level.
+    So an edge is checked once per level for all the sources, instead of once per source.
+
+    Different batches of sources are independent, so each thread runs it's own batches, with it's own bitsets.
 */
 
 //Implementation Examples:
 
+#pragma once
+
+#include "csr_graph.cpp"
 #include <vector>
 #include <queue>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 
 using namespace std;
 
-//Traversing every node in a connected undirected graph
+//Traversing every node in a connected undirected graph, given as a vector<vector<int>> or a CsrGraph
 
-void bfs(vector<vector<int>>& adjacencies) {
+template<class Graph>
+void bfs(const Graph& adjacencies) {
     vector<bool> vis(adjacencies.size(), false);
     queue<int> q;
 
@@ -45,4 +97,218 @@ void bfs(vector<vector<int>>& adjacencies) {
 
         q.pop();
     }
-}
\ No newline at end of file
+}
+
+//Direction-optimizing parallel bfs from source, on a CsrGraph.
+//incoming is the transposed graph, or null if the graph is undirected. Unreached nodes have depth and parent -1, and the source is it's own parent.
+
+struct BfsResult {
+    vector<int> depth, parent;
+};
+
+const int BFS_ALPHA = 15, BFS_BETA = 18;
+const long long BFS_PARALLEL_EDGES = 1 << 14; //edges a level checks per thread, at least, so smaller levels run on fewer threads.
+
+template<class W>
+BfsResult directionOptimizingBfs(const CsrGraph<W>& graph, int source, const CsrGraph<W>* incoming = nullptr, int threads = thread::hardware_concurrency()) {
+    int n = graph.size();
+    const CsrGraph<W>& in = incoming ? *incoming : graph;
+    threads = max(1, threads);
+
+    BfsResult result{vector<int>(n, -1), vector<int>(n, -1)};
+    vector<int>& depth = result.depth;
+    vector<int>& parent = result.parent;
+
+    vector<int> queue(n);
+    long long queueBegin = 0, queueEnd = 0; //the frontier is queue[queueBegin, queueEnd).
+    int words = (n + 63)/64;
+    vector<uint64_t> frontier(words), next(words);
+
+    depth[source] = 0;
+    parent[source] = source;
+    queue[queueEnd++] = source;
+
+    long long edgesToCheck = graph.degree(source), unexploredEdges = graph.edges() - graph.degree(source);
+    bool bottomUp = false;
+    long long frontierSize = 1;
+
+    //Threads worth using for a level that checks up to edges edges.
+    auto partsFor = [threads](long long edges) { return (int)max(1LL, min<long long>(threads, edges/BFS_PARALLEL_EDGES)); };
+
+    for(int level = 0; frontierSize > 0; level++) {
+        if(!bottomUp && edgesToCheck > unexploredEdges/BFS_ALPHA) {
+            //queue -> bitmap.
+            fill(frontier.begin(), frontier.end(), 0);
+            for(long long i = queueBegin; i < queueEnd; i++) frontier[queue[i]/64] |= uint64_t(1) << (queue[i]%64);
+            bottomUp = true;
+        }
+
+        atomic<long long> found(0), foundEdges(0);
+
+        if(bottomUp) {
+            fill(next.begin(), next.end(), 0);
+            int parts = partsFor(n + unexploredEdges);
+
+            runThreads(parts, [&](int t) {
+                int begin = (long long)words*t/parts*64, end = min<long long>(n, (long long)words*(t+1)/parts*64);
+                long long count = 0, edges = 0;
+
+                for(int v = begin; v < end; v++) {
+                    if(parent[v] != -1) continue;
+
+                    for(int u : in[v]) {
+                        if(frontier[u/64] >> (u%64) & 1) {
+                            parent[v] = u;
+                            depth[v] = level+1;
+                            next[v/64] |= uint64_t(1) << (v%64);
+                            count++;
+                            edges += graph.degree(v);
+                            break;
+                        }
+                    }
+                }
+
+                found += count, foundEdges += edges;
+            });
+
+            swap(frontier, next);
+        }else {
+            atomic<long long> nextEnd(queueEnd);
+            int parts = partsFor(edgesToCheck);
+
+            runThreads(parts, [&](int t) {
+                long long begin = queueBegin + (queueEnd - queueBegin)*t/parts, end = queueBegin + (queueEnd - queueBegin)*(t+1)/parts;
+                vector<int> discovered;
+                long long edges = 0;
+
+                for(long long i = begin; i < end; i++) {
+                    int u = queue[i];
+
+                    for(int v : graph[u]) {
+                        int unset = -1;
+                        if(__atomic_load_n(&parent[v], __ATOMIC_RELAXED) == -1 && __atomic_compare_exchange_n(&parent[v], &unset, u, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                            depth[v] = level+1;
+                            discovered.push_back(v);
+                            edges += graph.degree(v);
+                        }
+                    }
+                }
+
+                long long at = nextEnd.fetch_add(discovered.size());
+                copy(discovered.begin(), discovered.end(), queue.begin() + at);
+                found += discovered.size(), foundEdges += edges;
+            });
+
+            queueBegin = queueEnd;
+            queueEnd = nextEnd;
+        }
+
+        long long previousSize = frontierSize;
+        frontierSize = found;
+        edgesToCheck = foundEdges;
+        unexploredEdges -= foundEdges;
+
+        if(bottomUp && frontierSize < previousSize && frontierSize < n/BFS_BETA) {
+            //bitmap -> queue.
+            queueBegin = queueEnd = 0;
+            for(int v = 0; v < n; v++) {
+                if(frontier[v/64] >> (v%64) & 1) queue[queueEnd++] = v;
+            }
+            bottomUp = false;
+        }
+    }
+
+    return result;
+}
+
+//Multi-source bfs on a CsrGraph, advancing 64*Words sources at once per batch, with batches split among threads.
+
+template<int Words>
+struct SourceSet {
+    uint64_t bits[Words];
+
+    bool any() const {
+        uint64_t all = 0;
+        for(int i = 0; i < Words; i++) all |= bits[i];
+        return all != 0;
+    }
+};
+
+//Calls reached(i, v, distance) the first time sources[first+i] reaches v, for each source of the batch starting at first.
+template<int Words, class W, class Reached>
+void multiSourceBfsBatch(const CsrGraph<W>& graph, const vector<int>& sources, int first, Reached reached,
+                         vector<SourceSet<Words>>& seen, vector<SourceSet<Words>>& visit, vector<SourceSet<Words>>& visitNext) {
+    int n = graph.size(), count = min<int>(64*Words, sources.size() - first);
+    SourceSet<Words> empty{};
+    fill(seen.begin(), seen.end(), empty);
+    fill(visit.begin(), visit.end(), empty);
+    fill(visitNext.begin(), visitNext.end(), empty);
+
+    for(int i = 0; i < count; i++) {
+        int s = sources[first+i];
+        seen[s].bits[i/64] |= uint64_t(1) << (i%64);
+        visit[s].bits[i/64] |= uint64_t(1) << (i%64);
+        reached(i, s, 0);
+    }
+
+    for(int level = 1; ; level++) {
+        bool active = false;
+
+        for(int v = 0; v < n; v++) {
+            if(!visit[v].any()) continue;
+
+            for(int u : graph[v]) {
+                for(int w = 0; w < Words; w++) visitNext[u].bits[w] |= visit[v].bits[w];
+            }
+        }
+
+        for(int u = 0; u < n; u++) {
+            for(int w = 0; w < Words; w++) {
+                uint64_t fresh = visitNext[u].bits[w] & ~seen[u].bits[w];
+                seen[u].bits[w] |= fresh;
+                visit[u].bits[w] = fresh;
+                visitNext[u].bits[w] = 0;
+                active |= fresh != 0;
+
+                for(; fresh; fresh &= fresh-1) reached(64*w + __builtin_ctzll(fresh), u, level);
+            }
+        }
+
+        if(!active) break;
+    }
+}
+
+template<int Words, class W, class Reached>
+void multiSourceBfs(const CsrGraph<W>& graph, const vector<int>& sources, Reached reached, int threads) {
+    const int BATCH = 64*Words;
+    int batches = (sources.size() + BATCH-1)/BATCH;
+    atomic<int> nextBatch(0);
+
+    runThreads(max(1, min(threads, batches)), [&](int) {
+        vector<SourceSet<Words>> seen(graph.size()), visit(graph.size()), visitNext(graph.size());
+
+        for(int batch = nextBatch++; batch < batches; batch = nextBatch++) {
+            int first = batch*BATCH;
+            multiSourceBfsBatch<Words>(graph, sources, first, [&](int i, int v, int distance) { reached(first+i, v, distance); }, seen, visit, visitNext);
+        }
+    });
+}
+
+//distances[i][v] is the distance from sources[i] to v, or -1 if v is unreachable.
+template<int Words = 1, class W>
+vector<vector<int>> multiSourceBfsDistances(const CsrGraph<W>& graph, const vector<int>& sources, int threads = thread::hardware_concurrency()) {
+    vector<vector<int>> distances(sources.size(), vector<int>(graph.size(), -1));
+    multiSourceBfs<Words>(graph, sources, [&](int i, int v, int distance) { distances[i][v] = distance; }, threads);
+    return distances;
+}
+
+//histograms[i][d] is the number of nodes at distance d from sources[i].
+template<int Words = 1, class W>
+vector<vector<long long>> multiSourceBfsHistograms(const CsrGraph<W>& graph, const vector<int>& sources, int threads = thread::hardware_concurrency()) {
+    vector<vector<long long>> histograms(sources.size());
+    multiSourceBfs<Words>(graph, sources, [&](int i, int, int distance) {
+        if((int)histograms[i].size() <= distance) histograms[i].resize(distance+1, 0);
+        histograms[i][distance]++;
+    }, threads);
+    return histograms;
+}
@@ -0,0 +1,302 @@
+/*
+Compressed sparse row, or CSR for short, stores the adjacencies of a graph in a few flat arrays instead of one list per node.
+Time Complexity:
+    Building from an edge list: O(n+e), where n is the number of nodes and e the number of edges.
+    Reading the adjacencies of a node: O(1), plus O(1) per adjacency.
+
+With a list of adjacencies per node(vector<vector<int>>), each list is a separate allocation somewhere in the heap.
+A traversal then jumps from list to list, and the many small allocations also make building and freeing large graphs slow.
+
+CSR stores the same lists one after the other, in a single array, sorted by their source node:
+
+Graph:
+    0 -> 1, 2
+    1 -> 2
+    2 -> 0, 1, 3
+    3 -> (none)
+
+targets:    1 2 2 0 1 3
+offsets:    0 2 3 6 6
+
+The adjacencies of node u are targets[offsets[u]..offsets[u+1]-1], so offsets has n+1 elements, the last being e.
+If edges have weights, weights[i] is the weight of the edge to targets[i].
+
+Building from an edge list is a counting sort of the edges by their source node:
+    Count the number of edges leaving each node(it's out degree).
+    The prefix sums of the degrees are the offsets.
+    Write each edge's target to the next free position of it's source, in order, so the adjacencies keep the order of the edge list.
+
+    In parallel, the edge list is split in p contiguous chunks and each thread counts the degrees in it's chunk.
+    Thread t writes it's edges leaving u starting from offsets[u] plus the edges leaving u in chunks before t, so threads never write to the same position.
+
+Binary format:
+    As the graph is a few flat arrays, it can be stored in a file exactly as it's stored in memory: a header with n and e, then offsets, targets and weights.
+    Opening the file with mmap maps it to memory without reading or parsing it, and the arrays point straight into the mapping(zero-copy).
+    Pages are only read from disk when a traversal first touches them, so opening even a huge graph takes constant time.
+    Opening checks the header(n and m not negative, sizes that fit in the file) and that offsets starts at 0 and ends at m, which keeps every array in the file.
+    The offsets in between and the targets aren't checked, as that would read the whole file.
+
+
+Observations:
+    The graph can't get new edges without rebuilding it, so CSR suits graphs that are built once and traversed many times.
+
+    The transpose of the graph(every edge reversed) is also a CSR graph, built the same way with the edges reversed.
+    It gives the incoming adjacencies of each node, which some algorithms need.
+
+    graph[u] can be iterated like the adjacency list of u, so the algorithms taking vector<vector<int>> also take a CSR graph.
+    graph.weighted()[u] gives (weight, target) pairs, like the vector<vector<pii>> used by dijkstra.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include "../threads.cpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+//Read-only view of a contiguous array.
+
+template<class T>
+struct Range {
+    const T* first;
+    const T* last;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    long long size() const { return last - first; }
+    const T& operator[](long long i) const { return first[i]; }
+};
+
+//CSR graph with edge weights of type W. The arrays may be owned by the graph or point to a mapped file.
+
+template<class W = int>
+struct CsrGraph {
+    int n = 0;
+    long long m = 0;
+    const long long* offsets = nullptr;
+    const int* targets = nullptr;
+    const W* weights = nullptr; //null if the graph has no weights.
+
+    shared_ptr<const void> owner; //keeps the arrays alive while any copy of the graph exists.
+
+    int size() const { return n; }
+    long long edges() const { return m; }
+    long long degree(int u) const { return offsets[u+1] - offsets[u]; }
+
+    Range<int> operator[](int u) const { return {targets + offsets[u], targets + offsets[u+1]}; }
+    Range<W> weightsOf(int u) const { return {weights + offsets[u], weights + offsets[u+1]}; }
+
+    //(weight, target) pairs of each node, e.g, for dijkstra.
+    struct WeightedAdjacencies {
+        const int* target;
+        const W* weight;
+
+        struct Iterator {
+            const int* target;
+            const W* weight;
+
+            pair<W,int> operator*() const { return {*weight, *target}; }
+            Iterator& operator++() { target++, weight++; return *this; }
+            bool operator!=(const Iterator& other) const { return target != other.target; }
+        };
+
+        long long count;
+        Iterator begin() const { return {target, weight}; }
+        Iterator end() const { return {target + count, weight + count}; }
+        long long size() const { return count; }
+    };
+
+    struct WeightedView {
+        const CsrGraph* graph;
+
+        int size() const { return graph->n; }
+        WeightedAdjacencies operator[](int u) const {
+            long long first = graph->offsets[u];
+            return {graph->targets + first, graph->weights + first, graph->degree(u)};
+        }
+    };
+
+    WeightedView weighted() const { return {this}; }
+
+    CsrGraph transpose(int threads = 1) const;
+};
+
+template<class W>
+struct CsrStorage {
+    vector<long long> offsets;
+    vector<int> targets;
+    vector<W> weights;
+};
+
+//Builds the CSR graph of the edges sources[i] -> targets[i], with weights[i] if weights isn't null, keeping the order of the edges.
+template<class W>
+CsrGraph<W> buildCsrGraph(int n, long long m, const int* sources, const int* targets, const W* weights, int threads = 1) {
+    auto storage = make_shared<CsrStorage<W>>();
+    storage->offsets.assign(n+1, 0);
+    storage->targets.resize(m);
+    if(weights) {
+        storage->weights.resize(m);
+        storage->weights.reserve(1); //weights.data() isn't null even without edges, so the graph stays weighted.
+    }
+
+    threads = max(1, (int)min<long long>(threads, m/(1 << 16)));
+    auto chunk = [m, threads](int t) { return make_pair(m*t/threads, m*(t+1)/threads); };
+
+    //position[t][u] is the number of edges leaving u in chunk t, and then, where chunk t writes it's next edge leaving u.
+    vector<vector<long long>> position(threads, vector<long long>(n, 0));
+    runThreads(threads, [&](int t) {
+        auto [begin, end] = chunk(t);
+        for(long long i = begin; i < end; i++) position[t][sources[i]]++;
+    });
+
+    long long sum = 0;
+    for(int u = 0; u < n; u++) {
+        storage->offsets[u] = sum;
+        for(int t = 0; t < threads; t++) {
+            long long count = position[t][u];
+            position[t][u] = sum;
+            sum += count;
+        }
+    }
+    storage->offsets[n] = sum;
+
+    runThreads(threads, [&](int t) {
+        auto [begin, end] = chunk(t);
+        long long* pos = position[t].data();
+
+        for(long long i = begin; i < end; i++) {
+            long long p = pos[sources[i]]++;
+            storage->targets[p] = targets[i];
+            if(weights) storage->weights[p] = weights[i];
+        }
+    });
+
+    CsrGraph<W> graph;
+    graph.n = n, graph.m = m;
+    graph.offsets = storage->offsets.data();
+    graph.targets = storage->targets.data();
+    graph.weights = weights ? storage->weights.data() : nullptr;
+    graph.owner = storage;
+    return graph;
+}
+
+//The graph has weights if there's one per edge, so a graph without edges always has(empty) weights.
+template<class W = int>
+CsrGraph<W> buildCsrGraph(int n, const vector<pair<int,int>>& edges, const vector<W>& weights = {}, int threads = 1) {
+    bool weighted = weights.size() == edges.size();
+    if(!weighted && !weights.empty()) throw invalid_argument("buildCsrGraph needs one weight per edge, or none");
+
+    vector<int> sources(edges.size()), targets(edges.size());
+    for(size_t i = 0; i < edges.size(); i++) tie(sources[i], targets[i]) = edges[i];
+
+    W none{};
+    const W* weightsData = !weighted ? nullptr : weights.empty() ? &none : weights.data();
+    return buildCsrGraph<W>(n, edges.size(), sources.data(), targets.data(), weightsData, threads);
+}
+
+template<class W>
+CsrGraph<W> CsrGraph<W>::transpose(int threads) const {
+    vector<int> sources(m);
+    for(int u = 0; u < n; u++) {
+        fill(sources.begin() + offsets[u], sources.begin() + offsets[u+1], u);
+    }
+
+    return buildCsrGraph<W>(n, m, targets, sources.data(), weights, threads);
+}
+
+//Binary format: header, offsets[n+1], targets[m], padding to 8 bytes, weights[m].
+
+struct CsrFileHeader {
+    char magic[8];
+    uint32_t version, weightBytes; //weightBytes is 0 if the graph has no weights.
+    int64_t n, m;
+};
+
+const char CSR_MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+
+inline size_t csrTargetsEnd(const CsrFileHeader& header) {
+    size_t end = sizeof(CsrFileHeader) + (header.n+1)*sizeof(int64_t) + header.m*sizeof(int32_t);
+    return (end + 7)/8*8;
+}
+
+template<class W>
+void saveCsrGraph(const CsrGraph<W>& graph, const string& path) {
+    CsrFileHeader header;
+    memcpy(header.magic, CSR_MAGIC, sizeof(CSR_MAGIC));
+    header.version = 1;
+    header.weightBytes = graph.weights ? sizeof(W) : 0;
+    header.n = graph.n, header.m = graph.m;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file) throw runtime_error("cannot open " + path);
+
+    size_t padding = csrTargetsEnd(header) - (sizeof(header) + (graph.n+1)*sizeof(int64_t) + graph.m*sizeof(int32_t));
+    const char zeros[8] = {};
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+           && fwrite(graph.offsets, sizeof(int64_t), graph.n+1, file) == (size_t)graph.n+1
+           && (graph.m == 0 || fwrite(graph.targets, sizeof(int32_t), graph.m, file) == (size_t)graph.m) //targets may be null without edges.
+           && fwrite(zeros, 1, padding, file) == padding
+           && (!graph.weights || graph.m == 0 || fwrite(graph.weights, sizeof(W), graph.m, file) == (size_t)graph.m);
+
+    if(fclose(file) != 0 || !ok) throw runtime_error("cannot write " + path);
+}
+
+//Maps a graph saved by saveCsrGraph. The arrays point into the mapping, which is unmapped when the last copy of the graph is destroyed.
+template<class W = int>
+CsrGraph<W> openCsrGraph(const string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw runtime_error("cannot open " + path);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CsrFileHeader)) {
+        close(fd);
+        throw runtime_error(path + " is not a csr graph");
+    }
+
+    size_t bytes = st.st_size;
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) throw runtime_error("cannot map " + path);
+
+    shared_ptr<const void> owner(data, [bytes](const void* p) { munmap(const_cast<void*>(p), bytes); });
+
+    const CsrFileHeader& header = *(const CsrFileHeader*)data;
+    bool weighted = header.weightBytes != 0;
+
+    if(memcmp(header.magic, CSR_MAGIC, sizeof(CSR_MAGIC)) != 0 || header.version != 1 || (weighted && header.weightBytes != sizeof(W))) {
+        throw runtime_error(path + " is not a csr graph with this weight type");
+    }
+
+    //n and m are bounded by the file's size before computing the sizes of the arrays, so they can't overflow.
+    if(header.n < 0 || header.n > INT_MAX || header.m < 0 || (uint64_t)header.m > bytes
+       || bytes < csrTargetsEnd(header) + (weighted ? header.m*sizeof(W) : 0)) {
+        throw runtime_error(path + " is not a csr graph");
+    }
+
+    size_t targetsEnd = csrTargetsEnd(header);
+    const char* base = (const char*)data;
+    CsrGraph<W> graph;
+    graph.n = header.n, graph.m = header.m;
+    graph.offsets = (const long long*)(base + sizeof(CsrFileHeader));
+    graph.targets = (const int*)(base + sizeof(CsrFileHeader) + (header.n+1)*sizeof(int64_t));
+    graph.weights = weighted ? (const W*)(base + targetsEnd) : nullptr;
+    graph.owner = owner;
+
+    if(graph.offsets[0] != 0 || graph.offsets[graph.n] != graph.m) throw runtime_error(path + " is not a csr graph");
+    return graph;
+}
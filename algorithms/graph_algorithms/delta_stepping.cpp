@@ -0,0 +1,174 @@
+/*
+Delta-stepping finds the shortest path from a node u to every other node in a graph with non-negative weighted edges, in parallel.
+Time Complexity: O(n+e+L/delta) work per phase in the average case, where n is the number of nodes, e the number of edges, and L the maximum shortest path distance.
+
+Dijkstra's algorithm(see dijkstra_algorithm.cpp) visits nodes strictly one at a time, from the closest to u to the furthest, so it can't be split among threads.
+Delta-stepping relaxes this order: nodes are grouped by distance into buckets of width delta, and all the nodes of a bucket are processed at once.
+
+Bucket i holds the nodes with tentative distance in [i*delta, (i+1)*delta).
+Edges are split in light edges(weight <= delta) and heavy edges(weight > delta).
+
+The algorithm processes buckets in increasing order. For the first non-empty bucket i:
+    While bucket i is not empty:
+        Remove all of it's nodes, and relax all of their light edges, in parallel.
+        Relaxing a light edge may put a node in bucket i again, so this repeats until no node is added to it.
+    Then, relax the heavy edges of every node removed from bucket i, in parallel.
+    A heavy edge leads to a later bucket, so it only needs to be relaxed once, after the node's distance is final.
+
+Relaxing an edge to v is done with an atomic minimum on dist[v]: dist[v] is replaced only if the new distance is smaller, and if two threads try it at once, the smallest wins.
+The thread that decreased dist[v] adds v to the bucket of it's new distance. A node may then be in several buckets, and it's outdated entries are skipped.
+
+Only the non-empty buckets are stored, in a map from their index, and the next bucket processed is the smallest index in it.
+The indexes go up to (longest distance)/delta, which can be huge for a small delta and large weights(e.g, delta = 1 with weights of 10^9),
+so an array with every bucket up to the last one would allocate, and scan, mostly empty buckets.
+The non-empty buckets are always within ceil(maxWeight/delta)+1 of each other, so the map stays small for any reasonable delta.
+
+Choosing delta:
+    delta = 1(with integer weights) makes every bucket a single distance, which is dijkstra with buckets: little parallelism.
+    delta = infinity makes every edge light and everything a single bucket, which is the bellman-ford algorithm: lots of parallelism, but nodes are relaxed many times.
+    For random weights, Meyer and Sanders show delta around (maximum weight)/(maximum degree) works well, which is used when no delta is given(with the average degree).
+
+
+Observations:
+    The result is exactly the same as dijkstra's, which is used to validate it.
+
+    The graph must have weights: a CsrGraph without them(weights is null) throws invalid_argument.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include "csr_graph.cpp"
+#include "dijkstra_algorithm.cpp"
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <thread>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+
+//Single source shortest paths on a CsrGraph, in parallel.
+
+const int DELTA_STEPPING_PARALLEL_NODES = 64; //nodes per thread, at least, so small frontiers run on fewer threads.
+
+//Replaces target with value if value is smaller, returning whether it did.
+template<class Dist>
+bool atomicMin(Dist& target, Dist value) {
+    Dist current;
+    __atomic_load(&target, &current, __ATOMIC_RELAXED);
+
+    while(value < current) {
+        if(__atomic_compare_exchange(&target, &current, &value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return true;
+    }
+
+    return false;
+}
+
+//(maximum weight)/(average degree), at least 1 for integer weights.
+template<class W>
+double chooseDelta(const CsrGraph<W>& graph) {
+    if(!graph.weights) throw invalid_argument("delta stepping needs a weighted graph");
+    if(graph.edges() == 0) return 1;
+
+    W maxWeight = *max_element(graph.weights, graph.weights + graph.edges());
+    double averageDegree = (double)graph.edges() / graph.size();
+    double delta = maxWeight / averageDegree;
+
+    return is_integral<W>::value ? max(1.0, floor(delta)) : (delta > 0 ? delta : 1);
+}
+
+//Distance from source to every node, or numeric_limits<Dist>::max() if unreachable, where Dist is long long for integer weights.
+//delta <= 0 picks delta with chooseDelta.
+template<class W>
+auto deltaStepping(const CsrGraph<W>& graph, int source, double delta = 0, int threads = thread::hardware_concurrency()) {
+    using Dist = conditional_t<is_integral<W>::value, long long, W>;
+    const Dist INF = numeric_limits<Dist>::max();
+    if(!graph.weights) throw invalid_argument("delta stepping needs a weighted graph");
+
+    int n = graph.size();
+    if(delta <= 0) delta = chooseDelta(graph);
+    threads = max(1, threads);
+
+    vector<Dist> dist(n, INF);
+    map<size_t, vector<int>> buckets{{0, {source}}}; //only the non-empty buckets.
+    vector<long long> removedFrom(n, -1), inRound(n, -1); //last bucket each node was removed from, last round each node was in the frontier.
+    dist[source] = 0;
+
+    auto bucketOf = [delta](Dist d) { return (size_t)(d / delta); };
+
+    //Relaxes the light(or heavy) edges of nodes, and adds the decreased nodes to their buckets.
+    auto relax = [&](const vector<int>& nodes, bool light) {
+        vector<vector<pair<size_t,int>>> requests(threads);
+
+        int parts = min<int>(threads, max<size_t>(1, nodes.size()/DELTA_STEPPING_PARALLEL_NODES));
+        runThreads(parts, [&](int t) {
+            size_t begin = nodes.size()*t/parts, end = nodes.size()*(t+1)/parts;
+
+            for(size_t i = begin; i < end; i++) {
+                int u = nodes[i];
+                Dist du;
+                __atomic_load(&dist[u], &du, __ATOMIC_RELAXED);
+                const int* targets = graph.targets + graph.offsets[u];
+                const W* weights = graph.weights + graph.offsets[u];
+
+                for(long long k = 0; k < graph.degree(u); k++) {
+                    if((weights[k] <= delta) != light) continue;
+
+                    Dist candidate = du + weights[k];
+                    if(atomicMin(dist[targets[k]], candidate)) requests[t].emplace_back(bucketOf(candidate), targets[k]);
+                }
+            }
+        });
+
+        for(auto& threadRequests : requests) {
+            for(auto [bucket, node] : threadRequests) buckets[bucket].push_back(node);
+        }
+    };
+
+    long long round = 0;
+    while(!buckets.empty()) {
+        size_t i = buckets.begin()->first;
+        vector<int> removed;
+
+        while(!buckets[i].empty()) {
+            vector<int> frontier;
+            swap(frontier, buckets[i]);
+
+            //Skips outdated entries, and nodes already in this frontier.
+            size_t kept = 0;
+            for(int node : frontier) {
+                if(bucketOf(dist[node]) != i || inRound[node] == round) continue;
+                inRound[node] = round;
+                frontier[kept++] = node;
+
+                if(removedFrom[node] != (long long)i) {
+                    removedFrom[node] = i;
+                    removed.push_back(node);
+                }
+            }
+            frontier.resize(kept);
+            round++;
+
+            relax(frontier, true);
+        }
+
+        buckets.erase(i);
+        relax(removed, false);
+    }
+
+    return dist;
+}
+
+//Compares deltaStepping with the sequential dijkstra from dijkstra_algorithm.cpp.
+template<class W>
+bool validateDeltaStepping(const CsrGraph<W>& graph, int source, double delta = 0, int threads = thread::hardware_concurrency()) {
+    auto dist = deltaStepping(graph, source, delta, threads);
+    using Dist = typename decltype(dist)::value_type;
+
+    auto expected = shortestPaths<IndexedDaryHeap<Dist>>(graph.weighted(), {source});
+    return dist == expected.dist;
+}
@@ -16,8 +16,16 @@ In case of multiple connected components or the graph is directed and not strong
 
 Observations:
     DFS is normally recursively implemented, using the function call stack as it's stack.
+    The recursion is as deep as the longest path in the dfs tree, which may be n, and overflows the call stack for large graphs(e.g, a path or a grid).
 
-    A non-recursive dfs must mark nodes visited in the moment they're added to the stack, else they might be visited more than once.
+    A non-recursive dfs that pushes every non-visited adjacency must mark nodes visited in the moment they're added to the stack, else they might be visited more than once.
+    That visits every node, but not in dfs order: a node is marked by the first node that sees it, instead of the one that reaches it first in depth.
+
+    Iterative dfs with edge cursors:
+        To get the same order as the recursive dfs, the stack holds, for each node in the current path, the node and the position of the next adjacency to look at(it's cursor).
+        The top node looks at it's next adjacency, and if it's not visited, it's pushed, which is the same as the recursive call.
+        When a node has no adjacencies left, it's popped, which is the same as returning from the call.
+        The stack holds at most one entry per node, so it never grows beyond n, and a workspace reused across searches never allocates after the first one.
 
     DFS's execution generates a tree, whose edges are categorized as:
         Tree edges: edges pointing to an unvisited descendant,thus, used to find new nodes.
@@ -25,23 +33,46 @@ Observations:
         Cross edges: edges pointing to a node in another subtree.
         Forward edges: edges pointing to a visited descendant.
 
+    With the time each node is discovered(pre) and finished(post), for an edge u->v to a visited node v:
+        If v isn't finished, it's in the current path, so it's an ancestor of u: back edge.
+        If v is finished and pre[u] < pre[v], v was discovered and finished during u's search: forward edge.
+        Else, v was finished before u was discovered: cross edge.
+
     For an undirected graph, it's dfs tree will only have tree edges and back edges.
+    Each undirected edge is stored as two directed edges, so the edge back to the parent must be skipped(once, so a parallel edge still counts).
+    The other direction of a back edge, from the ancestor to the finished descendant, is seen as a forward edge.
 
-    A back edge closes a cycle on the graph.
+    A back edge closes a cycle on the graph. A directed graph without cycles(a DAG) has a topological order: the reverse of the order nodes are finished.
 
     The lowlink of a vertex u is the lowest reachable discovery time from u.
+    Here, it's the lowest discovery time reachable from u's subtree through a single back edge: low[u] = min(pre[u], pre[v] for back edges u->v, low[c] for children c).
+    In an undirected graph:
+        A tree edge p-u is a bridge(removing it disconnects the graph) if low[u] > pre[p]: no back edge from u's subtree gets above u.
+        A non-root node p is an articulation point(removing it disconnects the graph) if it has a child u with low[u] >= pre[p].
+        The root is an articulation point if it has more than one child.
+
+    Visitors:
+        The iterative dfs calls a visitor's hooks when a node is discovered or finished, and for each edge, with it's category.
+        The visitor is a template parameter, so the hooks are inlined, and the ones a visitor doesn't define(inherited from DfsVisitor) are empty and disappear.
+        Topological sort, cycle detection, bridges and articulation points are visitors on the same dfs, e.g, topological sort keeps the finished nodes, and stops at the first back edge.
 */
 
 //Implementation Examples:
 
+#pragma once
+
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <cstdint>
 
 using namespace std;
+using pii = pair<int,int>;
 
-//Recursive dfs
+//Recursive dfs, on a graph given as a vector<vector<int>> or a CsrGraph
 
-void dfs1(int node, vector<vector<int>>& adjacencies, vector<bool> vis) {
+template<class Graph>
+void dfs1(int node, const Graph& adjacencies, vector<bool>& vis) {
     vis[node] = true;
 
     for(int adjacency : adjacencies[node]) {
@@ -51,9 +82,10 @@ void dfs1(int node, vector<vector<int>>& adjacencies, vector<bool> vis) {
     }
 }
 
-//Iterative dfs
+//Iterative dfs, marking nodes as they're pushed(not in dfs order, see Observations)
 
-void dfs2(vector<vector<int>>& adjacencies) {
+template<class Graph>
+void dfs2(const Graph& adjacencies) {
     vector<bool> vis(adjacencies.size(), false);
     stack<int> s;
 
@@ -72,3 +104,225 @@ void dfs2(vector<vector<int>>& adjacencies) {
         }
     }
 }
+
+//Iterative dfs with edge cursors and visitor hooks
+
+//State of a dfs, reusable across searches. pre, post, low and parent are only valid for nodes discovered by the current search.
+struct DfsWorkspace {
+    struct Frame {
+        int node, cursor;   //cursor is the index of node's next adjacency.
+        bool parentSkipped; //in undirected graphs, the edge back to the parent is skipped once.
+    };
+
+    vector<int> pre, post, low, parent; //parent is -1 for roots.
+    vector<uint32_t> state; //stamp if discovered, stamp+1 if finished, less if undiscovered.
+    uint32_t stamp = 0;
+    vector<Frame> path;
+    int clock = 0;
+
+    DfsWorkspace(int n = 0) { reset(n); }
+
+    //Starts a new search on a graph of n nodes, in O(1). Only allocates if n is larger than in every previous search.
+    void reset(int n) {
+        if((int)state.size() < n) {
+            pre.resize(n), post.resize(n), low.resize(n), parent.resize(n);
+            state.resize(n, 0);
+            path.reserve(n);
+        }
+
+        stamp += 2;
+        if(stamp == 0) {
+            fill(state.begin(), state.end(), 0);
+            stamp = 2;
+        }
+
+        path.clear();
+        clock = 0;
+    }
+
+    bool discovered(int u) const { return state[u] >= stamp; }
+    bool finished(int u) const { return state[u] == stamp+1; }
+};
+
+//Visitor with every hook empty. Visitors inherit from it and define the hooks they need.
+struct DfsVisitor {
+    void discover(int) {}
+    void finish(int) {}
+    void treeEdge(int, int) {}
+    void backEdge(int, int) {}
+    void forwardEdge(int, int) {}
+    void crossEdge(int, int) {}
+    bool stop() const { return false; } //ends the search early once it returns true.
+};
+
+//Searches from source, if it's undiscovered, continuing the current search of ws(nodes discovered by it are skipped).
+template<class Graph, class Visitor>
+void iterativeDfsFrom(const Graph& adjacencies, int source, DfsWorkspace& ws, Visitor& visitor, bool undirected = false) {
+    if(ws.discovered(source)) return;
+
+    auto discover = [&](int u, int p) {
+        ws.state[u] = ws.stamp;
+        ws.pre[u] = ws.low[u] = ws.clock++;
+        ws.parent[u] = p;
+        ws.path.push_back({u, 0, !undirected || p == -1});
+        visitor.discover(u);
+    };
+
+    discover(source, -1);
+
+    while(!ws.path.empty() && !visitor.stop()) {
+        DfsWorkspace::Frame& frame = ws.path.back();
+        int u = frame.node;
+        const auto& row = adjacencies[u];
+
+        if(frame.cursor < (long long)row.size()) {
+            int v = row[frame.cursor++];
+
+            if(!frame.parentSkipped && v == ws.parent[u]) {
+                frame.parentSkipped = true;
+            }else if(!ws.discovered(v)) {
+                visitor.treeEdge(u, v);
+                discover(v, u);
+            }else if(!ws.finished(v)) {
+                ws.low[u] = min(ws.low[u], ws.pre[v]);
+                visitor.backEdge(u, v);
+            }else if(ws.pre[u] < ws.pre[v]) {
+                visitor.forwardEdge(u, v);
+            }else {
+                visitor.crossEdge(u, v);
+            }
+        }else {
+            ws.path.pop_back();
+            ws.state[u] = ws.stamp+1;
+            ws.post[u] = ws.clock++;
+            visitor.finish(u);
+
+            int p = ws.parent[u];
+            if(p != -1) ws.low[p] = min(ws.low[p], ws.low[u]);
+        }
+    }
+}
+
+//Searches the whole graph, starting a new search from each undiscovered node, in increasing order.
+template<class Graph, class Visitor>
+void iterativeDfs(const Graph& adjacencies, DfsWorkspace& ws, Visitor& visitor, bool undirected = false) {
+    int n = adjacencies.size();
+    ws.reset(n);
+
+    for(int u = 0; u < n && !visitor.stop(); u++) {
+        iterativeDfsFrom(adjacencies, u, ws, visitor, undirected);
+    }
+}
+
+//Algorithms on the iterative dfs. Each takes an optional workspace to reuse, else it uses a new one.
+
+//Nodes in topological order, or empty if the directed graph has a cycle.
+template<class Graph>
+vector<int> topologicalSort(const Graph& adjacencies, DfsWorkspace* workspace = nullptr) {
+    DfsWorkspace local;
+    DfsWorkspace& ws = workspace ? *workspace : local;
+
+    struct : DfsVisitor {
+        vector<int> order;
+        bool cyclic = false;
+
+        void finish(int u) { order.push_back(u); }
+        void backEdge(int, int) { cyclic = true; }
+        bool stop() const { return cyclic; }
+    } visitor;
+
+    iterativeDfs(adjacencies, ws, visitor);
+    if(visitor.cyclic) return {};
+
+    reverse(visitor.order.begin(), visitor.order.end());
+    return visitor.order;
+}
+
+//Nodes of a cycle, in order(the last one has an edge to the first), or empty if the graph has none.
+template<class Graph>
+vector<int> findCycle(const Graph& adjacencies, bool undirected = false, DfsWorkspace* workspace = nullptr) {
+    DfsWorkspace local;
+    DfsWorkspace& ws = workspace ? *workspace : local;
+
+    struct : DfsVisitor {
+        int from = -1, to = -1; //the first back edge.
+
+        void backEdge(int u, int v) { from = u, to = v; }
+        bool stop() const { return from != -1; }
+    } visitor;
+
+    iterativeDfs(adjacencies, ws, visitor, undirected);
+
+    vector<int> cycle;
+    if(visitor.from == -1) return cycle;
+
+    for(int u = visitor.from; u != visitor.to; u = ws.parent[u]) cycle.push_back(u);
+    cycle.push_back(visitor.to);
+    reverse(cycle.begin(), cycle.end());
+    return cycle;
+}
+
+template<class Graph>
+bool hasCycle(const Graph& adjacencies, bool undirected = false, DfsWorkspace* workspace = nullptr) {
+    return !findCycle(adjacencies, undirected, workspace).empty();
+}
+
+//Bridges (parent, child) of an undirected graph, given with both directions of each edge.
+template<class Graph>
+vector<pii> bridges(const Graph& adjacencies, DfsWorkspace* workspace = nullptr) {
+    DfsWorkspace local;
+    DfsWorkspace& ws = workspace ? *workspace : local;
+
+    struct Visitor : DfsVisitor {
+        const DfsWorkspace& ws;
+        vector<pii> found;
+
+        Visitor(const DfsWorkspace& ws) : ws(ws) {}
+
+        void finish(int u) {
+            int p = ws.parent[u];
+            if(p != -1 && ws.low[u] > ws.pre[p]) found.emplace_back(p, u);
+        }
+    } visitor(ws);
+
+    iterativeDfs(adjacencies, ws, visitor, true);
+    return visitor.found;
+}
+
+//Articulation points of an undirected graph, given with both directions of each edge, in increasing order.
+template<class Graph>
+vector<int> articulationPoints(const Graph& adjacencies, DfsWorkspace* workspace = nullptr) {
+    DfsWorkspace local;
+    DfsWorkspace& ws = workspace ? *workspace : local;
+
+    struct Visitor : DfsVisitor {
+        const DfsWorkspace& ws;
+        vector<bool> cut;
+        int rootChildren = 0;
+
+        Visitor(const DfsWorkspace& ws, int n) : ws(ws), cut(n, false) {}
+
+        void discover(int u) {
+            if(ws.parent[u] == -1) rootChildren = 0;
+        }
+
+        void treeEdge(int u, int) {
+            if(ws.parent[u] == -1) rootChildren++;
+        }
+
+        void finish(int u) {
+            int p = ws.parent[u];
+            if(p == -1) cut[u] = rootChildren > 1;
+            else if(ws.parent[p] != -1 && ws.low[u] >= ws.pre[p]) cut[p] = true;
+        }
+    } visitor(ws, adjacencies.size());
+
+    iterativeDfs(adjacencies, ws, visitor, true);
+
+    vector<int> points;
+    for(int u = 0; u < (int)adjacencies.size(); u++) {
+        if(visitor.cut[u]) points.push_back(u);
+    }
+
+    return points;
+}
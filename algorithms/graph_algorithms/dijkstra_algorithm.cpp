@@ -16,43 +16,281 @@ Node u is added to the priority queue, and the following steps are repeated unti
 
 Observations:
     Once a node is visited, it's minimum distance from u has been found and will not change, because every node in the priority queue has distance >= than dist[node].
+
+    Distances are sums of many weights, so they may not fit in the weight's type: with int weights, distances should be long long.
+
+    Keeping, for each node, the node it's distance was last decreased from(it's predecessor) gives a shortest path tree.
+    The shortest path to a node is found by following predecessors back to u.
+
+    Variations:
+        Multiple sources: every source starts with distance 0, giving the distance from each node to the closest source.
+        Single target: once the target is visited, it's distance is final, so the algorithm can stop.
+
+    Priority queues:
+        With a binary heap where entries are never removed(lazy deletion), a node is added every time it's distance decreases, so the heap holds O(e) entries.
+        An indexed heap keeps the position of each node in the heap, so decreasing a node's distance moves it's existing entry up(decrease-key).
+        The heap then never holds more than n entries, each node once.
+        A d-ary heap, where each node has d children, is shallower than a binary one: decrease-key, which moves up, is faster, and pop, which moves down, compares d children per level.
+        With d = 4, the children are contiguous, in the same cache line, and it's usually faster than d = 2.
+
+    Radix heap:
+        In dijkstra, the popped distances never decrease(the queue is monotone), and with integer weights, the distances are integers.
+        A radix heap keeps the last popped distance, last, and puts each distance d in the bucket of the highest bit where d and last differ(bucket 0 if d = last).
+        To pop, if bucket 0 is empty, the first non-empty bucket is emptied, last becomes it's minimum, and it's entries are put in buckets again.
+        Every entry goes down to lower buckets only, so each is moved at most 64 times(for 64 bit distances), and in practice far fewer.
+        A radix heap has no decrease-key, so a decreased node is added again, and outdated entries are skipped when popped.
 */
 
 //Implementation Examples:
 
+#pragma once
+
+#include "csr_graph.cpp"
+#include "../instrumentation.cpp"
 #include <vector>
 #include <queue>
 #include <climits>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
 
 using namespace std;
+using ll = long long;
 using pii = pair<int,int>;
 
 //Finding minimum path from node 0 to every other node in an undirected connected graph
+//The graph's adjacencies are (weight, node) pairs, as in a vector<vector<pii>> or a CsrGraph's weighted() view.
+//The Instrumentation policy counts the relaxations and stale pops(see ../instrumentation.cpp).
 
-void dijkstra(vector<vector<pii>>& adjacencies, vector<vector<int>>) {
+template<class Graph, class Instrumentation>
+void dijkstra(const Graph& adjacencies, Instrumentation& instrumentation) {
     vector<bool> vis(adjacencies.size(), false);
-    priority_queue<pii, vector<pii>, greater<pii>> prioq;
-    vector<int> dist(adjacencies.size(), INT_MAX);
+    priority_queue<pair<ll,int>, vector<pair<ll,int>>, greater<pair<ll,int>>> prioq;
+    vector<ll> dist(adjacencies.size(), LLONG_MAX);
 
     dist[0] = 0;
     prioq.emplace(dist[0],0);
 
     while(!prioq.empty()) {
         int node = prioq.top().second;
-        int nodeDist = prioq.top().first;
         prioq.pop();
 
-        if(vis[node]) continue;
+        if(vis[node]) {
+            instrumentation.stalePop();
+            continue;
+        }
         vis[node] = true;
 
         for(pii adjacency : adjacencies[node]) {
             int adj = adjacency.second;
             int adjWeight = adjacency.first;
 
-            if(!vis[adj] && dist[adj] > dist[node] + adjWeight) {
+            bool decreased = !vis[adj] && dist[adj] > dist[node] + adjWeight;
+            instrumentation.relaxation(decreased);
+
+            if(decreased) {
                 dist[adj] = dist[node] + adjWeight;
                 prioq.emplace(dist[adj], adj);
             }
         }
     }
-}
\ No newline at end of file
+}
+
+template<class Graph>
+void dijkstra(const Graph& adjacencies) {
+    NoInstrumentation none;
+    dijkstra(adjacencies, none);
+}
+
+//Indexed 4-ary heap, with decrease-key. Holds each node at most once.
+
+template<class Key, int D = 4>
+struct IndexedDaryHeap {
+    using Distance = Key;
+
+    vector<int> heap, pos; //pos[node] is node's index in heap, or -1.
+    vector<Key> key;
+
+    IndexedDaryHeap(int n) : pos(n, -1), key(n) {}
+
+    bool empty() const { return heap.empty(); }
+    int size() const { return heap.size(); }
+    pair<Key,int> top() const { return {key[heap[0]], heap[0]}; }
+
+    //Removes every node in O(size), so the heap can be reused without reallocating it.
+    void clear() {
+        for(int node : heap) pos[node] = -1;
+        heap.clear();
+    }
+
+    //Inserts node, or decreases it's key if it's already in the heap.
+    void push(int node, Key k) {
+        key[node] = k;
+
+        if(pos[node] == -1) {
+            pos[node] = heap.size();
+            heap.push_back(node);
+        }
+
+        siftUp(pos[node]);
+    }
+
+    pair<Key,int> pop() {
+        int top = heap[0];
+        pos[top] = -1;
+
+        if(heap.size() > 1) {
+            heap[0] = heap.back();
+            pos[heap[0]] = 0;
+            heap.pop_back();
+            siftDown(0);
+        }else {
+            heap.pop_back();
+        }
+
+        return {key[top], top};
+    }
+
+private:
+    void place(int i, int node) {
+        heap[i] = node;
+        pos[node] = i;
+    }
+
+    void siftUp(int i) {
+        int node = heap[i];
+
+        while(i > 0 && key[node] < key[heap[(i-1)/D]]) {
+            place(i, heap[(i-1)/D]);
+            i = (i-1)/D;
+        }
+
+        place(i, node);
+    }
+
+    void siftDown(int i) {
+        int node = heap[i], size = heap.size();
+
+        while(true) {
+            int first = D*i + 1, best = -1;
+            if(first >= size) break;
+
+            best = first;
+            for(int c = first+1; c < min(first+D, size); c++) {
+                if(key[heap[c]] < key[heap[best]]) best = c;
+            }
+
+            if(!(key[heap[best]] < key[node])) break;
+            place(i, heap[best]);
+            i = best;
+        }
+
+        place(i, node);
+    }
+};
+
+//Monotone radix heap for non-negative integer keys. Pushing a node again doesn't remove it's older entry.
+
+template<class Key>
+struct RadixHeap {
+    static_assert(is_integral<Key>::value, "radix heap keys must be integers");
+    using Distance = Key;
+
+    vector<pair<uint64_t,int>> buckets[65];
+    uint64_t last = 0;
+    long long count = 0;
+
+    RadixHeap(int) {}
+
+    bool empty() const { return count == 0; }
+
+    void push(int node, Key k) {
+        buckets[bucket(k)].emplace_back(k, node);
+        count++;
+    }
+
+    pair<Key,int> pop() {
+        if(buckets[0].empty()) {
+            int i = 1;
+            while(buckets[i].empty()) i++;
+
+            last = min_element(buckets[i].begin(), buckets[i].end())->first;
+            for(auto& entry : buckets[i]) buckets[bucket(entry.first)].push_back(entry);
+            buckets[i].clear();
+        }
+
+        auto [k, node] = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return {(Key)k, node};
+    }
+
+private:
+    int bucket(uint64_t k) const { return k == last ? 0 : 64 - __builtin_clzll(k ^ last); }
+};
+
+//Shortest paths from a set of sources, on a graph of (weight, node) adjacencies, e.g, a CsrGraph's weighted() view or a vector<vector<pii>>.
+//Queue is IndexedDaryHeap or RadixHeap, and it's Key is the distance type. If target isn't -1, stops once target's distance is found.
+//Like dijkstra, takes an optional Instrumentation policy.
+
+template<class Dist>
+struct ShortestPaths {
+    vector<Dist> dist; //numeric_limits<Dist>::max() for unreached nodes.
+    vector<int> pred;  //-1 for sources and unreached nodes.
+
+    bool reached(int node) const { return dist[node] != numeric_limits<Dist>::max(); }
+
+    //Nodes in the shortest path from a source to target, or empty if target wasn't reached.
+    vector<int> path(int target) const {
+        vector<int> nodes;
+        if(!reached(target)) return nodes;
+
+        for(int node = target; node != -1; node = pred[node]) nodes.push_back(node);
+        reverse(nodes.begin(), nodes.end());
+        return nodes;
+    }
+};
+
+template<class Queue = IndexedDaryHeap<ll>, class Graph, class Instrumentation>
+auto shortestPaths(const Graph& adjacencies, const vector<int>& sources, int target, Instrumentation& instrumentation) {
+    using Dist = typename Queue::Distance;
+
+    int n = adjacencies.size();
+    ShortestPaths<Dist> result{vector<Dist>(n, numeric_limits<Dist>::max()), vector<int>(n, -1)};
+    vector<Dist>& dist = result.dist;
+    Queue queue(n);
+
+    for(int source : sources) {
+        dist[source] = 0;
+        queue.push(source, 0);
+    }
+
+    while(!queue.empty()) {
+        auto [nodeDist, node] = queue.pop();
+        if(dist[node] < nodeDist) { //outdated entry.
+            instrumentation.stalePop();
+            continue;
+        }
+        if(node == target) break;
+
+        for(auto adjacency : adjacencies[node]) {
+            int adj = adjacency.second;
+            Dist adjDist = nodeDist + adjacency.first;
+
+            instrumentation.relaxation(adjDist < dist[adj]);
+            if(adjDist < dist[adj]) {
+                dist[adj] = adjDist;
+                result.pred[adj] = node;
+                queue.push(adj, adjDist);
+            }
+        }
+    }
+
+    return result;
+}
+
+template<class Queue = IndexedDaryHeap<ll>, class Graph>
+auto shortestPaths(const Graph& adjacencies, const vector<int>& sources, int target = -1) {
+    NoInstrumentation none;
+    return shortestPaths<Queue>(adjacencies, sources, target, none);
+}
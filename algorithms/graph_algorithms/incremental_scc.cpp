@@ -0,0 +1,185 @@
+/*
+Incremental scc maintains the strongly connected components(scc) of a directed graph while edges are inserted.
+Time Complexity:
+    Inserting an edge: O(n'+e') amortized, where n' and e' are the sccs and edges between the endpoints' positions in the topological order(see below).
+    Checking if two nodes are in the same scc: O(α(n)), where n is the number of nodes and α the inverse ackermann function.
+
+Running Tarjan's algorithm(see tarjan_algorithm.cpp) after each batch of insertions costs O(n+e) per batch, even if the batch changes nothing.
+Instead, the sccs are kept as a DAG(the condensation of the graph) together with a topological order of it, and both are fixed locally on each insertion.
+
+Each scc is a set in a union-find(disjoint set union), represented by one of it's nodes, so checking if u and v are in the same scc is checking find(u) == find(v).
+The union-find uses union by size(the scc with most nodes becomes the representative) and path halving, which gives the O(α(n)) bound.
+Each scc a has a position ord[a], so that every edge a->b between sccs has ord[a] < ord[b].
+
+Inserting u->v, where a = find(u) and b = find(v), uses the Pearce-Kelly algorithm:
+    If a == b or ord[a] < ord[b], the order is still valid, and nothing changes.
+    Otherwise, only the sccs with positions in [ord[b], ord[a]] may need to move:
+        F = the sccs reachable from b, with a dfs visiting only positions <= ord[a].
+        B = the sccs that reach a, with a dfs on the reversed edges visiting only positions >= ord[b].
+    If a isn't in F, there's no cycle: B must come before F, so the positions of B and F are pooled and sorted, and given first to B then to F, each keeping it's relative order.
+    If a is in F, the new edge closes a cycle, and every scc in both F and B(reachable from b and reaching a) is merged into one, C.
+    The first pooled positions are then given to B without C, then C, and the last ones to F without C.
+    The positions C no longer needs are left unused: moving F without C into them could put it before a node outside F and B with an edge to it.
+
+Sccs only ever merge, so the union-find never needs to split a set, which is why only insertions are supported.
+
+
+Observations:
+    The adjacency lists of merged sccs are concatenated, smallest into largest, and edges inside an scc are skipped when found.
+    The largest lists aren't always the representative's, so they're first swapped into it, in O(1), keeping the union by size.
+
+    The graph has a cycle iff some scc has more than one node, or some node has an edge to itself.
+
+    When most insertions go forward in the current order(e.g, edges of a DAG inserted in topological order), each costs O(1).
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+//Sccs of a graph with n nodes and no edges, under edge insertions
+
+struct IncrementalScc {
+    static const char FORWARD = 1, BACKWARD = 2;
+
+    vector<int> parent, ord, size; //size is the number of nodes of each scc, only kept for representatives.
+    vector<vector<int>> out, in; //edges leaving and entering each scc, as node ids, only kept for representatives.
+    vector<char> mark;           //whether each scc is in F and/or B during an insertion.
+    int components;
+    bool cyclic = false;
+
+    IncrementalScc(int n) : parent(n), ord(n), size(n, 1), out(n), in(n), mark(n, 0), components(n) {
+        iota(parent.begin(), parent.end(), 0);
+        iota(ord.begin(), ord.end(), 0);
+    }
+
+    int find(int u) {
+        while(parent[u] != u) {
+            parent[u] = parent[parent[u]];
+            u = parent[u];
+        }
+
+        return u;
+    }
+
+    bool sameScc(int u, int v) { return find(u) == find(v); }
+    int componentCount() const { return components; }
+    bool hasCycle() const { return cyclic; }
+
+    //Returns whether the edge merged some sccs.
+    bool insertEdge(int u, int v) {
+        int a = find(u), b = find(v);
+        if(a == b) {
+            cyclic = true;
+            return false;
+        }
+
+        out[a].push_back(v);
+        in[b].push_back(u);
+        if(ord[a] < ord[b]) return false;
+
+        int lower = ord[b], upper = ord[a];
+        vector<int> forward = reach(b, out, FORWARD, [&](int c) { return ord[c] <= upper; });
+        vector<int> backward = reach(a, in, BACKWARD, [&](int c) { return lower <= ord[c]; });
+        bool cycle = mark[a] & FORWARD;
+
+        vector<int> positions;
+        for(int c : forward) positions.push_back(ord[c]);
+        for(int c : backward) if(!(mark[c] & FORWARD)) positions.push_back(ord[c]);
+        sort(positions.begin(), positions.end());
+
+        auto byOrd = [&](int x, int y) { return ord[x] < ord[y]; };
+        sort(forward.begin(), forward.end(), byOrd);
+        sort(backward.begin(), backward.end(), byOrd);
+
+        //B without C, then C, take the first positions, and F without C the last ones.
+        vector<int> before, after, merged;
+        for(int c : backward) {
+            if(mark[c] & FORWARD) merged.push_back(c);
+            else before.push_back(c);
+        }
+
+        for(int c : forward) {
+            if(!(mark[c] & BACKWARD)) after.push_back(c);
+        }
+
+        for(int c : forward) mark[c] = 0;
+        for(int c : backward) mark[c] = 0;
+        if(cycle) before.push_back(merge(merged));
+
+        for(size_t i = 0; i < before.size(); i++) ord[before[i]] = positions[i];
+        for(size_t i = 0; i < after.size(); i++) ord[after[i]] = positions[positions.size() - after.size() + i];
+
+        return cycle;
+    }
+
+    void insertEdges(const vector<pair<int,int>>& edges) {
+        for(auto [u, v] : edges) insertEdge(u, v);
+    }
+
+    //Representatives of the sccs, in topological order.
+    vector<int> topologicalOrder() {
+        vector<int> order;
+        for(int u = 0; u < (int)parent.size(); u++) if(parent[u] == u) order.push_back(u);
+
+        sort(order.begin(), order.end(), [&](int x, int y) { return ord[x] < ord[y]; });
+        return order;
+    }
+
+private:
+    //Sccs reachable from start through edges, visiting only sccs c with allowed(c), and marking them with bit.
+    template<class Allowed>
+    vector<int> reach(int start, const vector<vector<int>>& edges, char bit, Allowed allowed) {
+        vector<int> visited{start}, stack{start};
+        mark[start] |= bit;
+
+        while(!stack.empty()) {
+            int c = stack.back();
+            stack.pop_back();
+
+            for(int node : edges[c]) {
+                int d = find(node);
+                if((mark[d] & bit) || !allowed(d)) continue;
+
+                mark[d] |= bit;
+                visited.push_back(d);
+                stack.push_back(d);
+            }
+        }
+
+        return visited;
+    }
+
+    //Merges the sccs into one, returning it's representative.
+    int merge(const vector<int>& sccs) {
+        int rep = *max_element(sccs.begin(), sccs.end(), [&](int x, int y) { return size[x] < size[y]; });
+        int largest = *max_element(sccs.begin(), sccs.end(), [&](int x, int y) {
+            return out[x].size() + in[x].size() < out[y].size() + in[y].size();
+        });
+
+        //The largest lists are moved into rep, and rep's lists are appended with the others'.
+        swap(out[rep], out[largest]);
+        swap(in[rep], in[largest]);
+
+        for(int c : sccs) {
+            if(c == rep) continue;
+
+            parent[c] = rep;
+            size[rep] += size[c];
+            out[rep].insert(out[rep].end(), out[c].begin(), out[c].end());
+            in[rep].insert(in[rep].end(), in[c].begin(), in[c].end());
+            vector<int>().swap(out[c]);
+            vector<int>().swap(in[c]);
+        }
+
+        components -= sccs.size()-1;
+        cyclic = true;
+        return rep;
+    }
+};
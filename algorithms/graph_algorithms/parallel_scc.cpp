@@ -0,0 +1,262 @@
+/*
+Parallel scc finds the strongly connected components(scc) of a directed graph using multiple threads.
+Time Complexity: O((n+e)*d) work in the worst case, where n is the number of nodes, e the number of edges, and d the diameter of the graph, but close to O(n+e) on most real graphs.
+
+Tarjan's algorithm(see tarjan_algorithm.cpp) is a single dfs, and dfs is inherently sequential: a node's visit depends on every node visited before it.
+Reachability, however, can be computed in parallel with a bfs, where every node of a frontier is expanded at once.
+This algorithm finds sccs with reachability only, in three steps:
+
+Trim:
+    A node with no incoming edges(or no outgoing edges), other than from itself, can't be in a cycle, so it's a scc by itself.
+    Removing it may leave it's adjacencies without incoming(or outgoing) edges, so they're removed too, and so on.
+    Each thread removes some of the nodes in the current frontier, and decrements the degrees of their adjacencies atomically.
+    In most real graphs, a large fraction of the nodes are trivial sccs, removed here in O(n+e).
+
+Forward-backward:
+    The scc of a node p is the intersection of the nodes reachable from p(forward) and the nodes that reach p(backward).
+    Both are found with parallel bfs, the backward one on the transpose of the graph, and only through nodes reached by the forward one.
+    Real graphs usually have one giant scc, so p is the node with the largest in degree * out degree, which is likely in it.
+
+Coloring:
+    Every remaining node starts with it's own id as it's color, and colors are propagated along edges, each node keeping the largest color that reaches it.
+    When no color changes, the color of a node v is the largest id among the nodes that reach v.
+    A node r with color r(a root) isn't reached by any node with a larger id, so every node in r's scc also has color r.
+    r's scc is then the set of nodes with color r that reach r, found with a backward bfs from every root at once, through nodes of the same color.
+    Each round removes at least one scc(the one of the largest remaining id), and it's repeated until every node has a scc.
+
+
+Renumbering:
+    The sccs are found in an order that depends on the threads, so at the end they're renumbered to the ids Tarjan's algorithm gives them, which are in topological order.
+    Tarjan's numbers a scc when it's first discovered node finishes, in a dfs that starts from each unvisited node in increasing order.
+    With the sccs already known, a plain dfs in the same order finds these ids, without Tarjan's lowlinks and stack of nodes.
+    This dfs is sequential and takes O(n+e), so it bounds the speedup over Tarjan's.
+
+
+Observations:
+    The result is exactly the same as Tarjan's, which is used to validate it.
+
+    Threads only communicate through atomic operations on shared arrays, which need sequentially consistent order where a thread writes one value and then reads another:
+        Trim: a thread decrements one of the degrees of v, and then reads both of them to see if v can be trimmed.
+        Coloring: a node u in the frontier clears queued[u], and then reads color[u], while another thread raises color[u], and then queues u if queued[u] is clear.
+        If either pair was reordered, u could miss the raised color and not be queued again, so the color would never reach it's adjacencies, splitting it's scc.
+    Relaxed operations(no order) are used everywhere else.
+
+    Frontiers smaller than SCC_PARALLEL_NODES per thread are expanded by fewer threads, as a small frontier takes less time than starting the threads.
+
+    Coloring is slow on long chains of sccs, as colors move one edge per round, which is why the giant scc and the trivial ones are removed first.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include "csr_graph.cpp"
+#include "tarjan_algorithm.cpp"
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+//Sccs of a CsrGraph, in parallel. incoming is it's transpose, built if null.
+
+const int SCC_PARALLEL_NODES = 1 << 12; //nodes per thread, at least, when splitting a frontier or the nodes.
+
+//Runs visit(u, next) for every u in frontier, split among threads, and returns every node pushed into next.
+template<class Visit>
+vector<int> expandFrontier(const vector<int>& frontier, int threads, Visit visit) {
+    int parts = max<int>(1, min<long long>(threads, frontier.size()/SCC_PARALLEL_NODES));
+    vector<vector<int>> next(parts);
+
+    runThreads(parts, [&](int t) {
+        size_t begin = frontier.size()*t/parts, end = frontier.size()*(t+1)/parts;
+        for(size_t i = begin; i < end; i++) visit(frontier[i], next[t]);
+    });
+
+    for(int t = 1; t < parts; t++) next[0].insert(next[0].end(), next[t].begin(), next[t].end());
+    return move(next[0]);
+}
+
+//Nodes u in [0,n) for which keep(u) is true, in increasing order.
+template<class Keep>
+vector<int> collectNodes(int n, int threads, Keep keep) {
+    int parts = max(1, min(threads, n/SCC_PARALLEL_NODES));
+    vector<vector<int>> nodes(parts);
+
+    runThreads(parts, [&](int t) {
+        for(int u = (long long)n*t/parts; u < (long long)n*(t+1)/parts; u++) {
+            if(keep(u)) nodes[t].push_back(u);
+        }
+    });
+
+    for(int t = 1; t < parts; t++) nodes[0].insert(nodes[0].end(), nodes[t].begin(), nodes[t].end());
+    return move(nodes[0]);
+}
+
+inline bool claim(int& target, int expected, int value, int order = __ATOMIC_RELAXED) {
+    return __atomic_compare_exchange_n(&target, &expected, value, false, order, __ATOMIC_RELAXED);
+}
+
+//Renumbers the sccs of result to the ids Tarjan's algorithm gives them, with a dfs in the same order.
+template<class W>
+void renumberLikeTarjan(const CsrGraph<W>& graph, SccResult& result) {
+    int n = graph.size(), next = result.count;
+    vector<int>& component = result.component;
+    vector<int> first(result.count, -1), id(result.count); //first[c] is the first discovered node of c.
+    vector<bool> visited(n, false);
+    vector<pair<int,long long>> path; //dfs path, as (node, next edge to try) pairs.
+
+    auto discover = [&](int u) {
+        visited[u] = true;
+        if(first[component[u]] == -1) first[component[u]] = u;
+        path.emplace_back(u, graph.offsets[u]);
+    };
+
+    for(int root = 0; root < n; root++) {
+        if(visited[root]) continue;
+        discover(root);
+
+        while(!path.empty()) {
+            auto& [u, edge] = path.back();
+
+            if(edge < graph.offsets[u+1]) {
+                int v = graph.targets[edge++];
+                if(!visited[v]) discover(v);
+                continue;
+            }
+
+            if(first[component[u]] == u) id[component[u]] = --next; //Tarjan's pops u's scc here.
+            path.pop_back();
+        }
+    }
+
+    for(int& c : component) c = id[c];
+}
+
+template<class W>
+SccResult parallelScc(const CsrGraph<W>& graph, const CsrGraph<W>* incoming = nullptr, int threads = thread::hardware_concurrency()) {
+    int n = graph.size();
+    threads = max(1, threads);
+
+    CsrGraph<W> transpose;
+    if(!incoming) {
+        transpose = graph.transpose(threads);
+        incoming = &transpose;
+    }
+
+    SccResult result{vector<int>(n, -1), 0};
+    int* component = result.component.data(); //-1 while the node has no scc.
+    int* count = &result.count;
+
+    auto newScc = [count] { return __atomic_fetch_add(count, 1, __ATOMIC_RELAXED); };
+    auto active = [component](int u) { return __atomic_load_n(&component[u], __ATOMIC_RELAXED) == -1; };
+
+    //Trim.
+    vector<int> inDegree(n), outDegree(n);
+    runThreads(threads, [&](int t) {
+        for(int u = (long long)n*t/threads; u < (long long)n*(t+1)/threads; u++) {
+            for(int v : graph[u]) outDegree[u] += v != u;
+            for(int v : (*incoming)[u]) inDegree[u] += v != u;
+        }
+    });
+
+    auto trimmed = [&](int u) { return __atomic_load_n(&inDegree[u], __ATOMIC_SEQ_CST) == 0 || __atomic_load_n(&outDegree[u], __ATOMIC_SEQ_CST) == 0; };
+    vector<int> frontier = collectNodes(n, threads, trimmed);
+    for(int u : frontier) component[u] = (*count)++;
+
+    while(!frontier.empty()) {
+        frontier = expandFrontier(frontier, threads, [&](int u, vector<int>& next) {
+            auto decrement = [&](Range<int> adjacencies, vector<int>& degree) {
+                for(int v : adjacencies) {
+                    if(v == u || !active(v)) continue;
+                    __atomic_fetch_sub(&degree[v], 1, __ATOMIC_SEQ_CST);
+                    if(trimmed(v) && claim(component[v], -1, -2)) next.push_back(v);
+                }
+            };
+
+            decrement(graph[u], inDegree);
+            decrement((*incoming)[u], outDegree);
+        });
+
+        for(int u : frontier) component[u] = newScc();
+    }
+
+    //Forward-backward from the node most likely in the giant scc.
+    vector<int> remaining = collectNodes(n, threads, active);
+    if(remaining.empty()) {
+        renumberLikeTarjan(graph, result);
+        return result;
+    }
+
+    int pivot = *max_element(remaining.begin(), remaining.end(), [&](int a, int b) {
+        return (long long)inDegree[a]*outDegree[a] < (long long)inDegree[b]*outDegree[b];
+    });
+
+    vector<int> mark(n, 0); //1 if reached forward, 2 if also reached backward.
+    mark[pivot] = 1;
+    for(frontier = {pivot}; !frontier.empty(); ) {
+        frontier = expandFrontier(frontier, threads, [&](int u, vector<int>& next) {
+            for(int v : graph[u]) {
+                if(active(v) && claim(mark[v], 0, 1)) next.push_back(v);
+            }
+        });
+    }
+
+    int giant = newScc();
+    mark[pivot] = 2;
+    component[pivot] = giant;
+    for(frontier = {pivot}; !frontier.empty(); ) {
+        frontier = expandFrontier(frontier, threads, [&](int u, vector<int>& next) {
+            for(int v : (*incoming)[u]) {
+                if(claim(mark[v], 1, 2)) {
+                    component[v] = giant;
+                    next.push_back(v);
+                }
+            }
+        });
+    }
+
+    //Coloring, until every node has a scc.
+    vector<int> color(n), queued(n, 0); //queued[u] is whether u is already in the next frontier.
+    auto keepActive = [&](int u, vector<int>& next) { if(active(u)) next.push_back(u); };
+
+    while(!(remaining = expandFrontier(remaining, threads, keepActive)).empty()) {
+        for(int u : remaining) color[u] = u;
+
+        for(frontier = remaining; !frontier.empty(); ) {
+            frontier = expandFrontier(frontier, threads, [&](int u, vector<int>& next) {
+                __atomic_exchange_n(&queued[u], 0, __ATOMIC_SEQ_CST);
+                int c = __atomic_load_n(&color[u], __ATOMIC_SEQ_CST);
+
+                for(int v : graph[u]) {
+                    if(!active(v)) continue;
+
+                    int old = __atomic_load_n(&color[v], __ATOMIC_RELAXED);
+                    while(old < c && !__atomic_compare_exchange_n(&color[v], &old, c, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+                    if(old < c && claim(queued[v], 0, 1, __ATOMIC_SEQ_CST)) next.push_back(v);
+                }
+            });
+        }
+
+        frontier = expandFrontier(remaining, threads, [&](int u, vector<int>& next) { if(color[u] == u) next.push_back(u); });
+        for(int root : frontier) component[root] = newScc();
+
+        while(!frontier.empty()) {
+            frontier = expandFrontier(frontier, threads, [&](int u, vector<int>& next) {
+                for(int v : (*incoming)[u]) {
+                    if(color[v] == color[u] && claim(component[v], -1, component[u])) next.push_back(v);
+                }
+            });
+        }
+    }
+
+    renumberLikeTarjan(graph, result);
+    return result;
+}
+
+//Compares parallelScc with the sequential Tarjan's from tarjan_algorithm.cpp.
+template<class W>
+bool validateParallelScc(const CsrGraph<W>& graph, int threads = thread::hardware_concurrency()) {
+    SccResult parallel = parallelScc<W>(graph, nullptr, threads), sequential = stronglyConnectedComponents(graph);
+    return parallel.count == sequential.count && parallel.component == sequential.component;
+}
@@ -0,0 +1,203 @@
+/*
+Point-to-point shortest path finds the shortest path from a node s to a single node t, in a graph with non-negative weighted edges.
+Time Complexity: O((n'+e')logn'), where n' and e' are the nodes and edges explored, usually far fewer than the whole graph.
+
+Dijkstra's algorithm(see dijkstra_algorithm.cpp) can stop once t is visited, but it still explores every node closer to s than t is.
+When many queries are made, allocating and initializing the distances of all n nodes on each query also costs O(n), even if the search only explores a few nodes.
+
+Reusable workspaces:
+    The distances, predecessors and priority queue are allocated once, in a workspace, and reused by every query.
+    Instead of resetting every distance to infinite before each query, each node stores the query it's distance was last set in(a timestamp).
+    A distance set in an older query counts as infinite, so starting a new query only increments the current timestamp, in O(1).
+    Each thread has it's own workspace, and the graph is only read, so any number of threads can make queries at once.
+
+Bidirectional dijkstra:
+    A forward search from s(on the graph) and a backward search from t(on the reverse graph) run at once, each step advancing the side with the closest node in it's queue.
+    Each search explores about a ball around it's source, and two balls of half the radius hold far fewer nodes than one ball of the full radius.
+
+    Whenever a node v gets distances from both searches, df(v)+db(v) is the length of a path s->v->t, and the shortest one found is kept as best.
+    The searches can stop when topf+topb >= best, where topf and topb are the smallest distances in each queue:
+        Any shorter path would have an edge (u,v) with u visited by the forward search and v by the backward one, or a node in both.
+        Such a path was already seen when the second of it's ends was reached, so it's length is at least best.
+    Note that stopping when the first node is visited by both searches, which is a common mistake, may miss the shortest path.
+
+A* search:
+    A dijkstra that visits nodes by dist(s,v) + h(v), where h(v) estimates the distance from v to t, so nodes in the direction of t are visited first.
+    If h never overestimates the distance(it's admissible), the path found when t is visited is a shortest path.
+    If also h(u) <= weight(u,v) + h(v) for every edge(it's consistent), each node is visited once, otherwise a node may be visited again when it's distance decreases.
+    For example, in a grid or road network, the straight line distance to t times the smallest weight per unit of distance.
+    h(v) = 0 is admissible and consistent, and makes A* a plain dijkstra.
+
+
+Observations:
+    On a directed graph, the backward search needs the reverse graph(see csr_graph.cpp's transpose). On an undirected graph, the graph is it's own reverse.
+
+    The timestamps wrap around after 2^32 queries, when they're all cleared at once.
+
+    The graph and it's reverse must have weights: a CsrGraph without them(weights is null) throws invalid_argument when the PointToPoint is built.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include "csr_graph.cpp"
+#include "dijkstra_algorithm.cpp"
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+using namespace std;
+
+//Shortest s->t paths on a CsrGraph, with one reusable workspace per thread.
+
+template<class Dist>
+struct PathResult {
+    Dist dist = numeric_limits<Dist>::max(); //numeric_limits<Dist>::max() if t isn't reachable from s.
+    vector<int> path; //nodes from s to t, or empty if t isn't reachable.
+    long long visited = 0; //number of nodes popped from the queues.
+
+    bool reached() const { return dist != numeric_limits<Dist>::max(); }
+};
+
+//Distances and predecessors of one search, reset in O(1) with timestamps.
+template<class Dist>
+struct SearchSpace {
+    vector<Dist> dist;
+    vector<int> pred;
+    vector<uint32_t> stamp; //dist[v] and pred[v] are only valid if stamp[v] == current.
+    uint32_t current = 0;
+    IndexedDaryHeap<Dist> queue;
+
+    SearchSpace(int n) : dist(n), pred(n), stamp(n, 0), queue(n) {}
+
+    void reset() {
+        queue.clear();
+
+        if(++current == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            current = 1;
+        }
+    }
+
+    Dist get(int v) const { return stamp[v] == current ? dist[v] : numeric_limits<Dist>::max(); }
+
+    void set(int v, Dist d, int p) {
+        stamp[v] = current;
+        dist[v] = d;
+        pred[v] = p;
+    }
+};
+
+template<class W>
+struct PointToPoint {
+    using Dist = conditional_t<is_integral<W>::value, long long, W>;
+
+    struct Workspace {
+        SearchSpace<Dist> forward, backward;
+
+        Workspace(int n) : forward(n), backward(n) {}
+    };
+
+    CsrGraph<W> graph, reverse;
+
+    //reverse is the transpose of graph, built if not given. For undirected graphs, pass graph itself.
+    PointToPoint(const CsrGraph<W>& graph, const CsrGraph<W>& reverse = {}) : graph(graph), reverse(reverse) {
+        if(this->reverse.n != graph.n) this->reverse = graph.transpose();
+        if(!graph.weights || !this->reverse.weights) throw invalid_argument("point to point searches need a weighted graph");
+    }
+
+    //Each thread making queries needs it's own workspace.
+    Workspace workspace() const { return Workspace(graph.size()); }
+
+    PathResult<Dist> bidirectional(Workspace& ws, int s, int t) const {
+        SearchSpace<Dist>& f = ws.forward;
+        SearchSpace<Dist>& b = ws.backward;
+        f.reset(), b.reset();
+
+        PathResult<Dist> result;
+        int meet = s == t ? s : -1;
+        if(s == t) result.dist = 0;
+
+        f.set(s, 0, -1), f.queue.push(s, 0);
+        b.set(t, 0, -1), b.queue.push(t, 0);
+
+        while(!f.queue.empty() && !b.queue.empty()) {
+            Dist topf = f.queue.top().first, topb = b.queue.top().first;
+            if(result.reached() && result.dist <= topf + topb) break;
+
+            bool forward = topf <= topb;
+            SearchSpace<Dist>& side = forward ? f : b;
+            const SearchSpace<Dist>& other = forward ? b : f;
+            const CsrGraph<W>& g = forward ? graph : reverse;
+
+            auto [du, u] = side.queue.pop();
+            result.visited++;
+
+            for(long long k = g.offsets[u]; k < g.offsets[u+1]; k++) {
+                int v = g.targets[k];
+                Dist dv = du + g.weights[k];
+                if(!(dv < side.get(v))) continue;
+
+                side.set(v, dv, u);
+                side.queue.push(v, dv);
+
+                Dist otherDist = other.get(v);
+                if(otherDist != numeric_limits<Dist>::max() && dv + otherDist < result.dist) {
+                    result.dist = dv + otherDist;
+                    meet = v;
+                }
+            }
+        }
+
+        if(meet != -1) {
+            for(int v = meet; v != -1; v = f.pred[v]) result.path.push_back(v);
+            std::reverse(result.path.begin(), result.path.end());
+            for(int v = b.pred[meet]; v != -1; v = b.pred[v]) result.path.push_back(v);
+        }
+
+        return result;
+    }
+
+    //heuristic(v) is an admissible estimate of the distance from v to t.
+    template<class Heuristic>
+    PathResult<Dist> aStar(Workspace& ws, int s, int t, Heuristic heuristic) const {
+        SearchSpace<Dist>& f = ws.forward;
+        f.reset();
+
+        PathResult<Dist> result;
+        f.set(s, 0, -1), f.queue.push(s, heuristic(s));
+
+        while(!f.queue.empty()) {
+            int u = f.queue.pop().second;
+            result.visited++;
+
+            if(u == t) {
+                result.dist = f.get(t);
+                for(int v = t; v != -1; v = f.pred[v]) result.path.push_back(v);
+                std::reverse(result.path.begin(), result.path.end());
+                break;
+            }
+
+            Dist du = f.get(u);
+            for(long long k = graph.offsets[u]; k < graph.offsets[u+1]; k++) {
+                int v = graph.targets[k];
+                Dist dv = du + graph.weights[k];
+                if(!(dv < f.get(v))) continue;
+
+                f.set(v, dv, u);
+                f.queue.push(v, dv + heuristic(v));
+            }
+        }
+
+        return result;
+    }
+
+    //Unidirectional dijkstra that stops at t.
+    PathResult<Dist> dijkstra(Workspace& ws, int s, int t) const {
+        return aStar(ws, s, t, [](int) { return Dist(0); });
+    }
+};
@@ -18,18 +18,40 @@ The algorithm uses a dfs. During it's visit to node u, it does the following:
     This means everything on the stack from u onwards is on the same scc as u(more on this later).
     The algorithm then pops the stack until u is popped. All the popped elements compose a scc of the graph.
     This unstacking is what allows for the property on line 20 to be true.
+
+
+Observations:
+    The recursive version uses one call per node in the current dfs path, so a path of 10^6+ nodes overflows the call stack.
+    The iterative version keeps it's own stack of (node, index of the next adjacency to try) pairs instead, in a vector that grows as needed.
+    When a node's adjacencies are exhausted, it's popped, and it's lowlink is passed to the node below it, as the recursive call's return would.
+
+    A node is on the stack of nodes iff it was visited and has no scc yet, so no is_on_s array is needed.
+
+    The sccs are found in reverse topological order: when a scc is popped, every scc it reaches was already popped.
+    Numbering them backwards gives ids in topological order, where every edge between sccs goes from a lower id to a higher one.
+
+    Condensation:
+        The graph where each scc becomes a single node, with an edge between two sccs if any of their nodes have one, is a DAG.
+        With the ids in topological order, it's built as a CSR graph(see csr_graph.cpp) whose nodes are already topologically sorted.
 */
 
 //Implementation examples:
 
+#pragma once
+
+#include "csr_graph.cpp"
 #include <vector>
 #include <stack>
+#include <algorithm>
 
 using namespace std;
 
 //Finding sccs
 
-void tarjan(int node, int& currTime, vector<int>& lowlink, vector<int>& time, vector<vector<int>>& adjacencies, stack<int>& s, vector<bool>& is_on_s) {
+//The graph can be a vector<vector<int>> or a CsrGraph.
+
+template<class Graph>
+void tarjan(int node, int& currTime, vector<int>& lowlink, vector<int>& time, const Graph& adjacencies, stack<int>& s, vector<bool>& is_on_s) {
     lowlink[node] = time[node] = currTime;
     s.push(node);
     is_on_s[node] = true;
@@ -56,3 +78,108 @@ void tarjan(int node, int& currTime, vector<int>& lowlink, vector<int>& time, ve
         }
     }
 }
+
+//Iterative scc, on a graph given as a vector<vector<int>> or a CsrGraph
+
+struct SccResult {
+    vector<int> component; //component[u] is u's scc, with scc ids in topological order.
+    int count = 0;
+};
+
+template<class Graph>
+SccResult stronglyConnectedComponents(const Graph& adjacencies) {
+    int n = adjacencies.size();
+    SccResult result{vector<int>(n, -1), 0};
+    vector<int>& component = result.component;
+
+    vector<int> time(n, -1), lowlink(n), s;
+    vector<pair<int,long long>> path; //dfs path, as (node, next adjacency to try) pairs.
+    int currTime = 0;
+
+    for(int root = 0; root < n; root++) {
+        if(time[root] != -1) continue;
+
+        time[root] = lowlink[root] = currTime++;
+        s.push_back(root);
+        path.emplace_back(root, 0);
+
+        while(!path.empty()) {
+            int node = path.back().first;
+            const auto& adjs = adjacencies[node];
+
+            if(path.back().second < (long long)adjs.size()) {
+                int adj = adjs[path.back().second++];
+
+                if(time[adj] == -1) {
+                    time[adj] = lowlink[adj] = currTime++;
+                    s.push_back(adj);
+                    path.emplace_back(adj, 0);
+                }else if(component[adj] == -1) {
+                    lowlink[node] = min(lowlink[node], time[adj]);
+                }
+
+                continue;
+            }
+
+            path.pop_back();
+            if(!path.empty()) {
+                int parent = path.back().first;
+                lowlink[parent] = min(lowlink[parent], lowlink[node]);
+            }
+
+            if(lowlink[node] == time[node]) {
+                int v = -1;
+                while(v != node) {
+                    v = s.back();
+                    s.pop_back();
+                    component[v] = result.count;
+                }
+
+                result.count++;
+            }
+        }
+    }
+
+    for(int& c : component) c = result.count-1 - c;
+    return result;
+}
+
+//DAG of the sccs, with the sccs' ids as nodes, so node order is a topological order. Parallel edges are merged.
+template<class Graph>
+CsrGraph<> condensation(const Graph& adjacencies, const SccResult& sccs) {
+    int n = adjacencies.size(), k = sccs.count;
+
+    //Nodes sorted by scc, with a counting sort.
+    vector<int> first(k+1, 0), nodes(n);
+    for(int u = 0; u < n; u++) first[sccs.component[u]+1]++;
+    for(int c = 0; c < k; c++) first[c+1] += first[c];
+
+    vector<int> pos(first.begin(), first.end()-1);
+    for(int u = 0; u < n; u++) nodes[pos[sccs.component[u]]++] = u;
+
+    auto storage = make_shared<CsrStorage<int>>();
+    storage->offsets.assign(k+1, 0);
+    vector<int> lastFrom(k, -1); //last scc with an edge to each scc, to skip parallel edges.
+
+    for(int c = 0; c < k; c++) {
+        storage->offsets[c] = storage->targets.size();
+
+        for(int i = first[c]; i < first[c+1]; i++) {
+            for(int adj : adjacencies[nodes[i]]) {
+                int d = sccs.component[adj];
+                if(d == c || lastFrom[d] == c) continue;
+
+                lastFrom[d] = c;
+                storage->targets.push_back(d);
+            }
+        }
+    }
+    storage->offsets[k] = storage->targets.size();
+
+    CsrGraph<> dag;
+    dag.n = k, dag.m = storage->targets.size();
+    dag.offsets = storage->offsets.data();
+    dag.targets = storage->targets.data();
+    dag.owner = storage;
+    return dag;
+}
@@ -0,0 +1,174 @@
+/*
+Instrumentation counts the events that explain an algorithm's running time, e.g, the comparisons and swaps of a sort, or the edges relaxed by dijkstra.
+Time Complexity: O(1) per event, and nothing when it's disabled.
+
+An instrumented algorithm takes the instrumentation policy as a template parameter, and calls it's hooks where the events happen:
+    NoInstrumentation has empty hooks, which the compiler removes, so the algorithm compiles to the same code as without them.
+    CountingInstrumentation adds each event to a counter of it's stats.
+    HardwareInstrumentation also reads the cpu's hardware counters(cycles, cache misses and branch misses) around the call.
+
+instrument<Policy>(call) runs call(policy) with a fresh policy, and returns the stats of that call only:
+    OperationStats stats = instrument<CountingInstrumentation>([&](auto& counters) { quickSort(0, n-1, array, counters); });
+
+Events:
+    comparisons, swaps: of elements, in sorts(quickSort's partition).
+    relaxations: edges checked by a shortest path algorithm, of which decreases improved the distance of their node.
+    stalePops: entries popped from the priority queue of a node that had already been visited(outdated entries).
+    nodesTouched: nodes read by a segment tree operation(SegTree::query).
+
+
+Observations:
+    The hooks are templates, resolved at compile time, instead of virtual functions or a runtime flag, which would cost a branch or a call per event even when disabled.
+
+    Hardware counters use linux's perf_event_open, counting only user space events of the calling thread.
+    The three counters are opened as a group, so they're enabled and read together, over the same instructions.
+    perf_event_open may be unavailable(other systems, containers or perf_event_paranoid > 2 forbid it), and then the hardware stats are -1.
+    Opening the counters takes a few system calls, so they're opened once per instrument() call, outside the measured region.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//Stats of one instrumented call. Hardware counts are -1 if they weren't measured.
+
+struct OperationStats {
+    long long comparisons = 0, swaps = 0;
+    long long relaxations = 0, decreases = 0, stalePops = 0;
+    long long nodesTouched = 0;
+    long long cycles = -1, cacheMisses = -1, branchMisses = -1;
+};
+
+inline ostream& operator<<(ostream& out, const OperationStats& s) {
+    return out << "comparisons=" << s.comparisons << " swaps=" << s.swaps
+               << " relaxations=" << s.relaxations << " decreases=" << s.decreases << " stalePops=" << s.stalePops
+               << " nodesTouched=" << s.nodesTouched
+               << " cycles=" << s.cycles << " cacheMisses=" << s.cacheMisses << " branchMisses=" << s.branchMisses;
+}
+
+//Policies
+
+struct NoInstrumentation {
+    static constexpr bool enabled = false;
+
+    void comparison(long long = 1) {}
+    void swap(long long = 1) {}
+    void relaxation(bool) {}
+    void stalePop() {}
+    void nodeTouched(long long = 1) {}
+
+    void begin() {}
+    void end() {}
+};
+
+struct CountingInstrumentation {
+    static constexpr bool enabled = true;
+    OperationStats stats;
+
+    void comparison(long long count = 1) { stats.comparisons += count; }
+    void swap(long long count = 1) { stats.swaps += count; }
+    void relaxation(bool decreased) { stats.relaxations++, stats.decreases += decreased; }
+    void stalePop() { stats.stalePops++; }
+    void nodeTouched(long long count = 1) { stats.nodesTouched += count; }
+
+    void begin() {}
+    void end() {}
+};
+
+//Group of hardware counters of the calling thread: cycles, cache misses and branch misses.
+
+struct HardwareCounters {
+    static const int COUNTERS = 3;
+    int fd[COUNTERS] = {-1, -1, -1}; //fd[0] is the group's leader.
+
+    HardwareCounters() {
+#ifdef __linux__
+        const uint64_t events[COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+        for(int i = 0; i < COUNTERS; i++) {
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = events[i];
+            attr.disabled = i == 0; //the others follow the leader.
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, fd[0], 0);
+            if(fd[i] == -1) {
+                close();
+                return;
+            }
+        }
+#endif
+    }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+    ~HardwareCounters() { close(); }
+
+    bool available() const { return fd[0] != -1; }
+
+    void start() {
+#ifdef __linux__
+        if(!available()) return;
+        ioctl(fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    //Stops counting, and writes the counts since start() to stats.
+    void stop(OperationStats& stats) {
+#ifdef __linux__
+        if(!available()) return;
+        ioctl(fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        uint64_t values[1 + COUNTERS]; //number of counters, then each count.
+        if(read(fd[0], values, sizeof(values)) != sizeof(values)) return;
+        stats.cycles = values[1], stats.cacheMisses = values[2], stats.branchMisses = values[3];
+#endif
+    }
+
+private:
+    void close() {
+#ifdef __linux__
+        for(int& f : fd) {
+            if(f != -1) ::close(f);
+            f = -1;
+        }
+#endif
+    }
+};
+
+struct HardwareInstrumentation : CountingInstrumentation {
+    HardwareCounters counters;
+
+    void begin() { counters.start(); }
+    void end() { counters.stop(stats); }
+};
+
+//Runs call(policy) with a new Policy, between it's begin() and end(). Returns the stats of the call(empty for NoInstrumentation).
+
+template<class Policy, class Call>
+OperationStats instrument(Call call) {
+    Policy policy;
+    policy.begin();
+    call(policy);
+    policy.end();
+
+    if constexpr(Policy::enabled) return policy.stats;
+    else return OperationStats();
+}
@@ -27,11 +27,38 @@ Observations:
     Iterator upper_bound (Iterator first, Iterator last, const val)
 
     If the value is not found, the end iterator of given data strucure is returned.
+
+    Cache friendly layouts:
+        Binary search's first few middles are the same for every search, but the rest are spread through the whole array, so on large arrays almost every step is a cache miss.
+        Besides that, the comparison at each step goes either way with the same probability, so the cpu mispredicts about half of them.
+        For sorted arrays that don't change, both problems can be solved by storing the array in a different order.
+
+        Eytzinger layout:
+            The array is stored as an implicit binary search tree, in the order of a bfs through it: the root at index 1, and the children of index k at 2k and 2k+1.
+            The tree is built by an in-order traversal of these indexes, filling them with the sorted values in order.
+            The search starts at k = 1 and goes to k = 2k + (b[k] < target), with no branch, until k is past the end of the array.
+            The path taken is written in the bits of k, 1 for each right turn, so the lowerbound is the node where the last left turn happened:
+                it's found by removing the trailing 1s of k, and one more bit.
+            The 16 descendants of k four levels below are contiguous, in a single cache line, so they can be prefetched four steps ahead.
+
+        S-tree(static B-tree) layout:
+            Each node has B = 16 sorted keys and B+1 children: the children of node k are k*(B+1)+i+1, for i in [0,B].
+            For 4 byte keys, a node takes two cache lines: one with the keys, compared at every step, and one with their positions in the sorted array.
+            The search finds, in each node, the number i of keys < target, and goes to child i, so the search takes log_B(n) cache misses.
+            Since the keys in a node are contiguous, i is found with SIMD instructions: the target is compared against all 16 keys at once, and the number of set bits in the resulting mask is i.
+
+        As searches are independent, many of them can be done together, each step advancing every search of a group, so their cache misses overlap.
 */
 
 //Implementation examples:
 
 #include <vector>
+#include <limits>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -56,7 +83,7 @@ int binarySearch1(int target, vector<int>& array) {
     return ans;
 }
 
-//Looking for the first value strictly smaller than target.
+//Looking for the last value strictly smaller than target.
 
 int binarySearch2(int target, vector<int>& array) {
     int left = 0, right = array.size()-1, ans = -1;
@@ -67,7 +94,7 @@ int binarySearch2(int target, vector<int>& array) {
         if(target <= array[middle]) {
             right = middle - 1;
         }else if(array[middle] < target){
-            right = middle - 1;
+            left = middle + 1;
             ans = middle;
         }
     }
@@ -77,7 +104,7 @@ int binarySearch2(int target, vector<int>& array) {
 
 //Looking for the first value greater or equal to target.
 
-int binarySearch2(int target, vector<int>& array) {
+int binarySearch3(int target, vector<int>& array) {
     int left = 0, right = array.size()-1, ans = -1;
 
     while(left <= right) {
@@ -87,9 +114,197 @@ int binarySearch2(int target, vector<int>& array) {
             right = middle - 1;
             ans = middle;
         }else if(array[middle] < target){
-            right = middle + 1;
+            left = middle + 1;
         }
     }
 
     return ans;
-}
\ No newline at end of file
+}
+
+//Static index of a sorted array in Eytzinger layout. Searches return indexes of the sorted array, or n if there's no such value.
+
+template<class T>
+struct EytzingerIndex {
+    static constexpr int GROUP = 16; //searches advanced together by the batch functions.
+
+    vector<T> b;       //b[1..n] in bfs order, b[0] unused.
+    vector<int> index; //index[k] is the position of b[k] in the sorted array.
+    int n;
+
+    EytzingerIndex(const vector<T>& sorted) : b(sorted.size()+1), index(sorted.size()+1, (int)sorted.size()), n(sorted.size()) {
+        int t = 0;
+        build(sorted, t, 1);
+    }
+
+    int lowerBound(const T& target) const { return search(target, false); }
+    int upperBound(const T& target) const { return search(target, true); }
+    pair<int,int> equalRange(const T& target) const { return {lowerBound(target), upperBound(target)}; }
+
+    void lowerBoundBatch(const vector<T>& targets, vector<int>& out) const { searchBatch(targets, out, false); }
+    void upperBoundBatch(const vector<T>& targets, vector<int>& out) const { searchBatch(targets, out, true); }
+
+private:
+    void build(const vector<T>& sorted, int& t, int k) {
+        if(k <= n) {
+            build(sorted, t, 2*k);
+            index[k] = t;
+            b[k] = sorted[t++];
+            build(sorted, t, 2*k+1);
+        }
+    }
+
+    //Whether the search goes right at node k.
+    bool right(int k, const T& target, bool upper) const { return upper ? !(target < b[k]) : b[k] < target; }
+
+    int answer(int k) const {
+        k >>= __builtin_ffs(~k);
+        return k == 0 ? n : index[k];
+    }
+
+    int search(const T& target, bool upper) const {
+        int k = 1;
+
+        while(k <= n) {
+            __builtin_prefetch(b.data() + 16*k);
+            k = 2*k + right(k, target, upper);
+        }
+
+        return answer(k);
+    }
+
+    //Every search has the same number of steps, the tree's height, so groups of searches advance in lockstep.
+    void searchBatch(const vector<T>& targets, vector<int>& out, bool upper) const {
+        out.resize(targets.size());
+        int height = 0;
+        while((1 << height) <= n) height++;
+
+        int k[GROUP];
+        for(int base = 0; base < (int)targets.size(); base += GROUP) {
+            int group = min<int>(GROUP, targets.size() - base);
+            fill(k, k + group, 1);
+
+            for(int level = 0; level < height; level++) {
+                for(int j = 0; j < group; j++) {
+                    if(k[j] <= n) k[j] = 2*k[j] + right(k[j], targets[base+j], upper);
+                    __builtin_prefetch(b.data() + 16*k[j]);
+                }
+            }
+
+            for(int j = 0; j < group; j++) out[base+j] = answer(k[j]);
+        }
+    }
+};
+
+//Static index of a sorted array in S-tree layout, with B = 16 keys per node. Searches return indexes of the sorted array, or n if there's no such value.
+
+template<class T>
+struct STreeIndex {
+    static constexpr int B = 16;
+    static constexpr int GROUP = 16; //searches advanced together by the batch functions.
+
+    struct alignas(64) Node {
+        T keys[B];
+        int index[B]; //positions of the keys in the sorted array, n for padding.
+    };
+
+    vector<Node> nodes;
+    int n;
+
+    STreeIndex(const vector<T>& sorted) : nodes((sorted.size() + B-1)/B), n(sorted.size()) {
+        int t = 0;
+        build(sorted, t, 0);
+    }
+
+    int lowerBound(const T& target) const { return search(target, false); }
+    int upperBound(const T& target) const { return search(target, true); }
+    pair<int,int> equalRange(const T& target) const { return {lowerBound(target), upperBound(target)}; }
+
+    void lowerBoundBatch(const vector<T>& targets, vector<int>& out) const { searchBatch(targets, out, false); }
+    void upperBoundBatch(const vector<T>& targets, vector<int>& out) const { searchBatch(targets, out, true); }
+
+private:
+    static int child(int k, int i) { return k*(B+1) + i + 1; }
+
+    void build(const vector<T>& sorted, int& t, int k) {
+        if(k < (int)nodes.size()) {
+            for(int i = 0; i < B; i++) {
+                build(sorted, t, child(k, i));
+                nodes[k].keys[i] = t < n ? sorted[t] : numeric_limits<T>::max();
+                nodes[k].index[i] = t < n ? t++ : n;
+            }
+            build(sorted, t, child(k, B));
+        }
+    }
+
+    //Number of keys of node k that are < target, or <= target if upper.
+    int rank(int k, const T& target, bool upper) const {
+        const T* keys = nodes[k].keys;
+
+#ifdef __AVX2__
+        if constexpr(is_same<T, int>::value) {
+            __m256i x = _mm256_set1_epi32(target);
+            __m256i lo = _mm256_load_si256((const __m256i*)keys), hi = _mm256_load_si256((const __m256i*)(keys + 8));
+
+            if(upper) {
+                unsigned greater = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(lo, x)))
+                                 | _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(hi, x))) << 8;
+                return B - __builtin_popcount(greater);
+            }
+
+            unsigned less = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo)))
+                          | _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, hi))) << 8;
+            return __builtin_popcount(less);
+        }
+#endif
+
+        int count = 0;
+        for(int i = 0; i < B; i++) count += upper ? !(target < keys[i]) : keys[i] < target;
+        return count;
+    }
+
+    int search(const T& target, bool upper) const {
+        int ans = n;
+
+        for(int k = 0; k < (int)nodes.size(); ) {
+            int i = rank(k, target, upper);
+            if(i < B) ans = nodes[k].index[i];
+            k = child(k, i);
+        }
+
+        return ans;
+    }
+
+    //Searches end at different depths, as the last level isn't full, so groups of searches advance in lockstep until all of them leave the tree.
+    //Each step prefetches the next node of every search, which is loaded while the others' nodes are compared.
+    void searchBatch(const vector<T>& targets, vector<int>& out, bool upper) const {
+        out.resize(targets.size());
+        int size = nodes.size();
+
+        int k[GROUP], ans[GROUP];
+        for(int base = 0; base < (int)targets.size(); base += GROUP) {
+            int group = min<int>(GROUP, targets.size() - base);
+            fill(k, k + group, 0);
+            fill(ans, ans + group, n);
+
+            for(bool active = size > 0; active; ) {
+                active = false;
+
+                for(int j = 0; j < group; j++) {
+                    if(k[j] >= size) continue;
+
+                    int i = rank(k[j], targets[base+j], upper);
+                    if(i < B) ans[j] = nodes[k[j]].index[i];
+                    k[j] = child(k[j], i);
+
+                    if(k[j] < size) {
+                        __builtin_prefetch(nodes[k[j]].keys);
+                        __builtin_prefetch(nodes[k[j]].index);
+                        active = true;
+                    }
+                }
+            }
+
+            for(int j = 0; j < group; j++) out[base+j] = ans[j];
+        }
+    }
+};
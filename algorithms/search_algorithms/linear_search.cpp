@@ -9,11 +9,37 @@ If ans = -1, there is no such value in the sequence.
 
 Observations:
     Can be used to find every ocurrence of the value, rather than the last or first.
+
+    When looking for the first occurrence, the search can stop as soon as it's found.
+
+    Vectorized linear search:
+        Linear search has no dependency between iterations, so SIMD instructions can compare many elements at once:
+            The target is copied to every lane of a vector register(broadcast).
+            A whole vector of elements(8 ints with AVX2, 4 with SSE2) is compared against it at once, giving a vector with all bits set in the lanes that are equal.
+            The vector is reduced to an integer mask, with one bit per lane(movemask).
+        If the mask is zero, none of the elements are the target, which is the usual case, so most of the time is spent on a single branch per vector.
+        Otherwise:
+            First occurrence: the position of the lowest set bit(count trailing zeros) is the first match.
+            Count: the number of set bits(popcount) is added to the count.
+            Every occurrence: the positions of the set bits are written, removing the lowest one at a time.
+                The output may need a position per element, but allocating that much for every search is slower than the search itself.
+                Instead, the array is searched in chunks, and the output only grows when the next chunk could overflow it.
+            Multiple targets: the element vector is compared against each broadcast target, and the results are or'ed together before the movemask.
+        The search becomes limited by how fast the memory delivers the array, not by the comparisons.
+
+    The instructions available depend on the cpu running the program, not the one compiling it.
+    So every kernel is compiled for AVX2, SSE2 and without SIMD, and the best one the cpu supports is chosen when the program first searches(runtime dispatch).
 */
 
 //Implementation examples:
 
 #include <vector>
+#include <climits>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -25,7 +51,258 @@ int linearSearch(int target, vector<int>& array) {
     for(int i = 0; i < array.size(); i++) {
         if(array[i] == target) {
             ans = i;
+            break;
+        }
+    }
+
+    return ans;
+}
+
+//Vectorized searches of integers, with runtime dispatch. Searches for the first occurrence return -1 if there's none.
+
+const int MAX_NEEDLES = 8; //maximum number of targets searched at once.
+
+struct LinearSearchKernels {
+    long long (*find)(const int* array, long long n, int target);
+    long long (*count)(const int* array, long long n, int target);
+    long long (*findAll)(const int* array, long long n, int target, long long* positions); //returns the number of positions written.
+    long long (*findAny)(const int* array, long long n, const int* targets, int numTargets);
+};
+
+long long scalarFind(const int* array, long long n, int target) {
+    for(long long i = 0; i < n; i++) {
+        if(array[i] == target) return i;
+    }
+    return -1;
+}
+
+long long scalarCount(const int* array, long long n, int target) {
+    long long count = 0;
+    for(long long i = 0; i < n; i++) count += array[i] == target;
+    return count;
+}
+
+long long scalarFindAll(const int* array, long long n, int target, long long* positions) {
+    long long count = 0;
+    for(long long i = 0; i < n; i++) {
+        positions[count] = i;
+        count += array[i] == target;
+    }
+    return count;
+}
+
+long long scalarFindAny(const int* array, long long n, const int* targets, int numTargets) {
+    for(long long i = 0; i < n; i++) {
+        for(int t = 0; t < numTargets; t++) {
+            if(array[i] == targets[t]) return i;
+        }
+    }
+    return -1;
+}
+
+//Writes base + the position of every set bit of mask.
+inline long long writePositions(unsigned mask, long long base, long long* positions) {
+    long long count = 0;
+    for(; mask; mask &= mask-1) positions[count++] = base + __builtin_ctz(mask);
+    return count;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2"))) unsigned equalMask8(const int* p, __m256i target) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, target)));
+}
+
+__attribute__((target("avx2"))) long long avx2Find(const int* array, long long n, int target) {
+    __m256i t = _mm256_set1_epi32(target);
+    long long i = 0;
+
+    for(; i + 16 <= n; i += 16) {
+        unsigned mask = equalMask8(array + i, t) | equalMask8(array + i + 8, t) << 8;
+        if(mask) return i + __builtin_ctz(mask);
+    }
+
+    long long rest = scalarFind(array + i, n - i, target);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2,popcnt"))) long long avx2Count(const int* array, long long n, int target) {
+    __m256i t = _mm256_set1_epi32(target);
+    long long count = 0, i = 0;
+
+    for(; i + 16 <= n; i += 16) {
+        count += __builtin_popcount(equalMask8(array + i, t) | equalMask8(array + i + 8, t) << 8);
+    }
+
+    return count + scalarCount(array + i, n - i, target);
+}
+
+__attribute__((target("avx2"))) long long avx2FindAll(const int* array, long long n, int target, long long* positions) {
+    __m256i t = _mm256_set1_epi32(target);
+    long long count = 0, i = 0;
+
+    for(; i + 16 <= n; i += 16) {
+        unsigned mask = equalMask8(array + i, t) | equalMask8(array + i + 8, t) << 8;
+        if(mask) count += writePositions(mask, i, positions + count);
+    }
+
+    for(; i < n; i++) {
+        positions[count] = i;
+        count += array[i] == target;
+    }
+
+    return count;
+}
+
+__attribute__((target("avx2"))) long long avx2FindAny(const int* array, long long n, const int* targets, int numTargets) {
+    __m256i t[MAX_NEEDLES];
+    for(int j = 0; j < numTargets; j++) t[j] = _mm256_set1_epi32(targets[j]);
+    long long i = 0;
+
+    for(; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(array + i)), eq = _mm256_setzero_si256();
+        for(int j = 0; j < numTargets; j++) eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(v, t[j]));
+
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if(mask) return i + __builtin_ctz(mask);
+    }
+
+    long long rest = scalarFindAny(array + i, n - i, targets, numTargets);
+    return rest < 0 ? -1 : i + rest;
+}
+
+inline unsigned equalMask4(const int* p, __m128i target) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, target)));
+}
+
+long long sse2Find(const int* array, long long n, int target) {
+    __m128i t = _mm_set1_epi32(target);
+    long long i = 0;
+
+    for(; i + 8 <= n; i += 8) {
+        unsigned mask = equalMask4(array + i, t) | equalMask4(array + i + 4, t) << 4;
+        if(mask) return i + __builtin_ctz(mask);
+    }
+
+    long long rest = scalarFind(array + i, n - i, target);
+    return rest < 0 ? -1 : i + rest;
+}
+
+long long sse2Count(const int* array, long long n, int target) {
+    __m128i t = _mm_set1_epi32(target), counts = _mm_setzero_si128();
+    long long count = 0, i = 0;
+
+    //Each equal lane is -1, so subtracting the comparison counts matches per lane, flushed before they can overflow.
+    while(i + 4 <= n) {
+        long long blockEnd = min(n - n%4, i + 4LL*INT_MAX);
+        for(; i < blockEnd; i += 4) {
+            counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(array + i)), t));
         }
+
+        alignas(16) int lanes[4];
+        _mm_store_si128((__m128i*)lanes, counts);
+        count += (long long)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        counts = _mm_setzero_si128();
+    }
+
+    return count + scalarCount(array + i, n - i, target);
+}
+
+long long sse2FindAll(const int* array, long long n, int target, long long* positions) {
+    __m128i t = _mm_set1_epi32(target);
+    long long count = 0, i = 0;
+
+    for(; i + 8 <= n; i += 8) {
+        unsigned mask = equalMask4(array + i, t) | equalMask4(array + i + 4, t) << 4;
+        if(mask) count += writePositions(mask, i, positions + count);
+    }
+
+    for(; i < n; i++) {
+        positions[count] = i;
+        count += array[i] == target;
+    }
+
+    return count;
+}
+
+long long sse2FindAny(const int* array, long long n, const int* targets, int numTargets) {
+    __m128i t[MAX_NEEDLES];
+    for(int j = 0; j < numTargets; j++) t[j] = _mm_set1_epi32(targets[j]);
+    long long i = 0;
+
+    for(; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(array + i)), eq = _mm_setzero_si128();
+        for(int j = 0; j < numTargets; j++) eq = _mm_or_si128(eq, _mm_cmpeq_epi32(v, t[j]));
+
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if(mask) return i + __builtin_ctz(mask);
+    }
+
+    long long rest = scalarFindAny(array + i, n - i, targets, numTargets);
+    return rest < 0 ? -1 : i + rest;
+}
+
+#endif
+
+const LinearSearchKernels& linearSearchKernels() {
+    static const LinearSearchKernels kernels = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) return LinearSearchKernels{avx2Find, avx2Count, avx2FindAll, avx2FindAny};
+        if(__builtin_cpu_supports("sse2")) return LinearSearchKernels{sse2Find, sse2Count, sse2FindAll, sse2FindAny};
+#endif
+        return LinearSearchKernels{scalarFind, scalarCount, scalarFindAll, scalarFindAny};
+    }();
+
+    return kernels;
+}
+
+long long vectorizedFind(int target, const vector<int>& array) {
+    return linearSearchKernels().find(array.data(), array.size(), target);
+}
+
+long long vectorizedCount(int target, const vector<int>& array) {
+    return linearSearchKernels().count(array.data(), array.size(), target);
+}
+
+const long long FIND_ALL_CHUNK = 1 << 12; //elements searched between checks of the output's size.
+
+//Writes the position of every element equal to target to positions, resized to their number.
+//The array is searched in chunks, and positions only grows(doubling) when a chunk could overflow it, so it's sized by the matches and not by the array.
+//Passing the same positions to every call reuses it's memory.
+void vectorizedFindAll(int target, const vector<int>& array, vector<long long>& positions) {
+    auto findAll = linearSearchKernels().findAll;
+    long long n = array.size(), count = 0;
+
+    for(long long begin = 0; begin < n; begin += FIND_ALL_CHUNK) {
+        long long chunk = min(FIND_ALL_CHUNK, n - begin);
+        if((long long)positions.size() < count + chunk) positions.resize(max<long long>(2*positions.size(), count + chunk));
+
+        long long found = findAll(array.data() + begin, chunk, target, positions.data() + count);
+        for(long long j = count; j < count + found; j++) positions[j] += begin; //the kernel's positions are relative to the chunk.
+        count += found;
+    }
+
+    positions.resize(count);
+}
+
+vector<long long> vectorizedFindAll(int target, const vector<int>& array) {
+    vector<long long> positions;
+    vectorizedFindAll(target, array, positions);
+    return positions;
+}
+
+//Position of the first element equal to any of the targets, searching up to MAX_NEEDLES targets per pass.
+long long vectorizedFindAny(const vector<int>& targets, const vector<int>& array) {
+    long long ans = -1;
+
+    for(int first = 0; first < (int)targets.size(); first += MAX_NEEDLES) {
+        int numTargets = min<int>(MAX_NEEDLES, targets.size() - first);
+        long long end = ans < 0 ? array.size() : ans; //later passes only need to look before the best match so far.
+        long long found = linearSearchKernels().findAny(array.data(), end, targets.data() + first, numTargets);
+        if(found >= 0) ans = found;
     }
 
     return ans;
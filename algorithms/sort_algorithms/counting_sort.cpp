@@ -9,11 +9,47 @@ Then, by iterating through the array the numbers in the sequence can be retrieve
 Observations:
 
     As an array of size = number of possible values is allocated, counting sort is terrible when the range of possible values is large.
+
+    Counting sort can also be stable, moving the values themselves instead of rewriting them from the frequencies:
+        The prefix sums of the frequencies give, for each value, the position of it's first occurrence in the sorted sequence.
+        Iterating through the sequence, each value is written to it's position, and the position is incremented.
+        As values are written in the order they appear, equal values keep their relative order.
+
+Radix sort:
+    Radix sort sorts integers of b bits in O(n*b/d), using a stable counting sort on d bits(a digit) at a time.
+    The counting sorts go from the least significant digit to the most significant one(LSD).
+    After sorting by digit k, the sequence is sorted by the k+1 lowest digits, as ties in digit k keep their order from the previous sorts, which is the order of the lower digits.
+    The range of each counting sort is only 2^d, e.g. 256 for 8 bit digits, so it's small even for 64 bit keys.
+
+    Larger digits mean fewer passes over the data, but a larger frequency array, which stops fitting in the L1 cache past 11 bits or so.
+    32 bit keys take 4 passes with 8 bit digits, or 3 with 11 bit digits.
+
+    The frequencies of every digit can be counted in a single pass, before any sorting, as the frequencies of a digit don't depend on the order of the sequence.
+    If every value has the same digit k(some frequency of digit k is n), sorting by digit k changes nothing, and that pass is skipped.
+
+    Keys other than unsigned integers are mapped to unsigned integers with the same order:
+        Signed integers: the sign bit is flipped, so negative values come before positive ones.
+        IEEE floats: positive floats are ordered as their bits are, so only the sign bit is flipped.
+            Negative floats are ordered in reverse, so all their bits are flipped.
+
+    Each key can carry a payload, which is moved alongside it, so records are stably sorted by key.
+
+    Parallel radix sort:
+        The sequence is split in p contiguous chunks, one per thread, and each thread counts the frequencies of digit k on it's chunk.
+        The position where thread t writes it's first value with digit v is the number of values with digit < v, plus the number of values with digit v in chunks before t.
+        Then, each thread writes it's chunk independently, and the result is the same as the sequential stable counting sort.
 */
 
 //Implementation examples:
 
+#include "../threads.cpp"
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
 
 using namespace std;
 
@@ -23,7 +59,7 @@ void countingSort(int left, int right, vector<int>& array) {
     vector<int> freq(right-left+1, 0);
 
     for(int value : array) {
-        freq[value]++;
+        freq[value-left]++;
     }
 
     int arrayIndex = 0;
@@ -36,4 +72,139 @@ void countingSort(int left, int right, vector<int>& array) {
         }
     }
 
-}
\ No newline at end of file
+}
+
+//Maps each key type to an unsigned integer with the same order.
+//Any integral type(int, long long, unsigned long long, char...) maps to the unsigned type of the same size, with the sign bit flipped if it's signed.
+
+template<class Key, class = void>
+struct RadixKey;
+
+template<class Key>
+struct RadixKey<Key, enable_if_t<is_integral<Key>::value && !is_same<Key, bool>::value>> {
+    using Unsigned = make_unsigned_t<Key>;
+    static Unsigned toUnsigned(Key key) {
+        if(is_signed<Key>::value) return (Unsigned)key ^ (Unsigned(1) << (8*sizeof(Unsigned) - 1));
+        return key;
+    }
+};
+
+template<>
+struct RadixKey<float> {
+    using Unsigned = uint32_t;
+    static Unsigned toUnsigned(float key) {
+        Unsigned bits;
+        memcpy(&bits, &key, sizeof(bits));
+        return bits >> 31 ? ~bits : bits ^ (Unsigned(1) << 31);
+    }
+};
+
+template<>
+struct RadixKey<double> {
+    using Unsigned = uint64_t;
+    static Unsigned toUnsigned(double key) {
+        Unsigned bits;
+        memcpy(&bits, &key, sizeof(bits));
+        return bits >> 63 ? ~bits : bits ^ (Unsigned(1) << 63);
+    }
+};
+
+//LSD radix sort of keys(and optionally their payloads) with DigitBits bit digits, e.g, radixSort<11>(keys).
+
+struct NoPayload {};
+
+template<int DigitBits, class Key, class Value>
+void radixSort(Key* keys, Value* values, size_t n, int threads) {
+    using Unsigned = typename RadixKey<Key>::Unsigned;
+    const int DIGITS = (8*sizeof(Unsigned) + DigitBits-1)/DigitBits;
+    const size_t RADIX = size_t(1) << DigitBits;
+    const bool hasPayload = !is_same<Value, NoPayload>::value;
+
+    auto digit = [](Key key, int d) { return size_t(RadixKey<Key>::toUnsigned(key) >> (d*DigitBits)) & (RADIX-1); };
+
+    threads = max(1, (int)min<size_t>(threads, n/(1 << 16)));
+    auto chunk = [n, threads](int t) { return make_pair(n*t/threads, n*(t+1)/threads); };
+
+    //Frequencies of every digit, counted in a single pass.
+    vector<vector<size_t>> threadFreq(threads, vector<size_t>(DIGITS*RADIX, 0));
+    runThreads(threads, [&](int t) {
+        auto [begin, end] = chunk(t);
+        size_t* freq = threadFreq[t].data();
+
+        for(size_t i = begin; i < end; i++) {
+            for(int d = 0; d < DIGITS; d++) freq[d*RADIX + digit(keys[i], d)]++;
+        }
+    });
+
+    vector<Key> keysAux(n);
+    vector<Value> valuesAux(hasPayload ? n : 0);
+    Key *keysFrom = keys, *keysTo = keysAux.data();
+    Value *valuesFrom = values, *valuesTo = valuesAux.data();
+
+    vector<vector<size_t>> position(threads, vector<size_t>(RADIX));
+    bool reordered = false;
+
+    for(int d = 0; d < DIGITS; d++) {
+        size_t* freq = threadFreq[0].data() + d*RADIX;
+        vector<size_t> total(freq, freq + RADIX);
+        for(int t = 1; t < threads; t++) {
+            for(size_t v = 0; v < RADIX; v++) total[v] += threadFreq[t][d*RADIX + v];
+        }
+
+        if(*max_element(total.begin(), total.end()) == n) continue; //every key has the same digit d.
+
+        //The frequencies of each chunk were counted in the original order, so they're recounted for the current one.
+        if(1 < threads && reordered) {
+            runThreads(threads, [&](int t) {
+                auto [begin, end] = chunk(t);
+                vector<size_t>& chunkFreq = position[t];
+                fill(chunkFreq.begin(), chunkFreq.end(), 0);
+                for(size_t i = begin; i < end; i++) chunkFreq[digit(keysFrom[i], d)]++;
+            });
+        }else {
+            for(int t = 0; t < threads; t++) {
+                copy(threadFreq[t].begin() + d*RADIX, threadFreq[t].begin() + (d+1)*RADIX, position[t].begin());
+            }
+        }
+
+        size_t sum = 0;
+        for(size_t v = 0; v < RADIX; v++) {
+            for(int t = 0; t < threads; t++) {
+                size_t count = position[t][v];
+                position[t][v] = sum;
+                sum += count;
+            }
+        }
+
+        runThreads(threads, [&](int t) {
+            auto [begin, end] = chunk(t);
+            size_t* pos = position[t].data();
+
+            for(size_t i = begin; i < end; i++) {
+                size_t p = pos[digit(keysFrom[i], d)]++;
+                keysTo[p] = keysFrom[i];
+                if constexpr(!is_same<Value, NoPayload>::value) valuesTo[p] = move(valuesFrom[i]);
+            }
+        });
+
+        swap(keysFrom, keysTo);
+        swap(valuesFrom, valuesTo);
+        reordered = true;
+    }
+
+    if(keysFrom != keys) {
+        copy(keysFrom, keysFrom + n, keys);
+        if constexpr(!is_same<Value, NoPayload>::value) move(valuesFrom, valuesFrom + n, values);
+    }
+}
+
+template<int DigitBits = 8, class Key>
+void radixSort(vector<Key>& keys, int threads = 1) {
+    radixSort<DigitBits, Key, NoPayload>(keys.data(), nullptr, keys.size(), threads);
+}
+
+template<int DigitBits = 8, class Key, class Value>
+void radixSort(vector<Key>& keys, vector<Value>& values, int threads = 1) {
+    if(values.size() != keys.size()) throw invalid_argument("radixSort needs one value per key");
+    radixSort<DigitBits>(keys.data(), values.data(), keys.size(), threads);
+}
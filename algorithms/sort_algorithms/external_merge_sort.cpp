@@ -0,0 +1,298 @@
+/*
+External merge sort sorts a sequence of values that doesn't fit in memory, stored in a file.
+Time Complexity: O(nlogn), where n is the number of elements in the sequence.
+I/O Complexity: 2 reads and 2 writes of the whole file, as long as the number of runs(see below) is at most M/B, where M is the memory and B the size of a buffer.
+
+In practice, the time spent reading and writing the disk dominates the time spent comparing elements, so the algorithm minimizes the passes over the file.
+
+The algorithm works in two phases:
+
+Run formation:
+    The file is read in chunks as large as the memory allows, with large sequential reads.
+    Each chunk is sorted in memory(here, with the bottom-up merge sort from merge_sort.cpp) and written to a temporary file, as a sorted run.
+
+Merge:
+    All k runs are merged at once, with one input buffer per run and one output buffer.
+    The smallest element of the k runs' current elements is written to the output buffer, and it's run advances.
+    When a run's buffer is consumed, it's refilled with it's next block, and when the output buffer is full, it's written to the output file.
+
+    Finding the smallest of k elements each time is done with a loser tree:
+        A complete binary tree with the k runs as leafs, where each internal node stores the loser of the match between the winners of it's two subtrees.
+        The overall winner(the smallest element) is stored separately.
+        After the winner's run advances, it's new element only needs to play the matches on the path from it's leaf to the root, against the stored losers.
+        This takes logk comparisons per element, and unlike a heap, only one comparison per level.
+
+    Double buffering:
+        Each run has two buffers: while one is being consumed, the next block of the run is read into the other, in the background(read-ahead).
+        The output also has two buffers: while one is written to the file in the background, the other is filled(write-behind).
+        This way, the cpu merging and the disk reading/writing overlap.
+
+
+Observations:
+    Half of the memory is used for the chunk, and the other half as the auxiliar array of the merge sort.
+    In the merge, the memory is split among 2k+2 buffers, so if there are too many runs, the buffers get small and the disk accesses stop being sequential.
+    In that case, the runs can be merged in groups, over multiple passes.
+
+    The temporary files are deleted as soon as they're created, while kept open, so they're removed even if the program is interrupted.
+    Every file is closed by a FileDescriptor, so none leaks if a read or write fails midway and throws runtime_error.
+
+    Records must be trivially copyable, as they're read and written as raw bytes.
+*/
+
+//Implementation examples:
+
+#include "merge_sort.cpp"
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+//Sorting a file of fixed-width records larger than memory.
+
+struct ExternalSortStats {
+    size_t bytes = 0, runs = 0;
+    double readSeconds = 0, sortSeconds = 0, spillSeconds = 0, mergeSeconds = 0;
+
+    void report(ostream& out) const {
+        auto throughput = [this](double seconds) { return seconds > 0 ? bytes / seconds / (1 << 20) : 0; };
+
+        out << "runs: " << runs << ", bytes: " << bytes << "\n";
+        out << "read:  " << readSeconds << " s, " << throughput(readSeconds) << " MB/s\n";
+        out << "sort:  " << sortSeconds << " s, " << throughput(sortSeconds) << " MB/s\n";
+        out << "spill: " << spillSeconds << " s, " << throughput(spillSeconds) << " MB/s\n";
+        out << "merge: " << mergeSeconds << " s, " << throughput(mergeSeconds) << " MB/s\n";
+    }
+};
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+//Owns a file descriptor, closing it when destroyed, so it's closed even if an exception leaves the function that opened it.
+struct FileDescriptor {
+    int fd = -1;
+
+    explicit FileDescriptor(int fd) : fd(fd) {}
+    FileDescriptor(FileDescriptor&& other) : fd(other.fd) { other.fd = -1; }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    ~FileDescriptor() { if(fd >= 0) close(fd); }
+
+    operator int() const { return fd; }
+};
+
+//Reads up to bytes bytes at offset, returning how many were read(less than bytes only at the end of the file).
+size_t readAt(int fd, void* buffer, size_t bytes, off_t offset) {
+    size_t done = 0;
+
+    while(done < bytes) {
+        ssize_t got = pread(fd, (char*)buffer + done, bytes - done, offset + done);
+        if(got < 0 && errno == EINTR) continue;
+        if(got < 0) throw runtime_error(string("read failed: ") + strerror(errno));
+        if(got == 0) break;
+        done += got;
+    }
+
+    return done;
+}
+
+void writeAll(int fd, const void* buffer, size_t bytes) {
+    size_t done = 0;
+
+    while(done < bytes) {
+        ssize_t put = write(fd, (const char*)buffer + done, bytes - done);
+        if(put < 0 && errno == EINTR) continue;
+        if(put < 0) throw runtime_error(string("write failed: ") + strerror(errno));
+        done += put;
+    }
+}
+
+//Sorted run in a temporary file, read in blocks with one block of read-ahead.
+template<class Record>
+struct RunReader {
+    int fd;
+    off_t offset = 0; //offset of the next block to be read.
+    vector<Record> buffer, next;
+    size_t count = 0, pos = 0;
+    future<size_t> pending;
+
+    RunReader(int fd, size_t bufferRecords) : fd(fd), buffer(bufferRecords), next(bufferRecords) {
+        count = readAt(fd, buffer.data(), buffer.size()*sizeof(Record), 0) / sizeof(Record);
+        offset = count*sizeof(Record);
+        readAhead();
+    }
+
+    bool empty() const { return pos == count; }
+    const Record& head() const { return buffer[pos]; }
+
+    void advance() {
+        if(++pos < count) return;
+
+        size_t got = pending.get() / sizeof(Record);
+        if(got == 0) return;
+
+        swap(buffer, next);
+        count = got, pos = 0;
+        offset += got*sizeof(Record);
+        readAhead();
+    }
+
+    void readAhead() {
+        pending = async(launch::async, [this, offset = offset] {
+            return readAt(fd, next.data(), next.size()*sizeof(Record), offset);
+        });
+    }
+};
+
+//Output file written in blocks, one block being written in the background while the other is filled.
+template<class Record>
+struct RunWriter {
+    int fd;
+    vector<Record> buffer, writing;
+    size_t count = 0;
+    future<void> pending;
+
+    RunWriter(int fd, size_t bufferRecords) : fd(fd), buffer(bufferRecords), writing(bufferRecords) {}
+
+    void push(const Record& record) {
+        buffer[count++] = record;
+        if(count == buffer.size()) flush();
+    }
+
+    void flush() {
+        if(pending.valid()) pending.get();
+
+        swap(buffer, writing);
+        pending = async(launch::async, [this, bytes = count*sizeof(Record)] { writeAll(fd, writing.data(), bytes); });
+        count = 0;
+    }
+
+    void finish() {
+        flush();
+        pending.get();
+    }
+};
+
+//Loser tree over k runs. An empty run loses to every other, and ties are won by the lowest run, keeping the merge stable.
+template<class Record, class Compare>
+struct LoserTree {
+    vector<RunReader<Record>>& runs;
+    Compare comp;
+    int k;
+    vector<int> tree; //tree[0] is the winner, tree[1..k-1] the losers of each internal node.
+
+    LoserTree(vector<RunReader<Record>>& runs, Compare comp) : runs(runs), comp(comp), k(runs.size()), tree(max(1, k)) {
+        vector<int> winner(2*k);
+        for(int i = 0; i < k; i++) winner[k+i] = i;
+
+        for(int node = k-1; 0 < node; node--) {
+            int a = winner[2*node], b = winner[2*node+1];
+            winner[node] = beats(a, b) ? a : b;
+            tree[node] = beats(a, b) ? b : a;
+        }
+
+        tree[0] = winner[1];
+    }
+
+    bool beats(int a, int b) const {
+        if(runs[a].empty()) return false;
+        if(runs[b].empty()) return true;
+        if(comp(runs[a].head(), runs[b].head())) return true;
+        if(comp(runs[b].head(), runs[a].head())) return false;
+        return a < b;
+    }
+
+    bool empty() const { return runs[tree[0]].empty(); }
+    const Record& top() const { return runs[tree[0]].head(); }
+
+    void pop() {
+        int w = tree[0];
+        runs[w].advance();
+
+        for(int node = (w+k)/2; 0 < node; node /= 2) {
+            if(beats(tree[node], w)) swap(tree[node], w);
+        }
+
+        tree[0] = w;
+    }
+};
+
+template<class Record, class Compare = less<>>
+ExternalSortStats externalMergeSort(const string& inputPath, const string& outputPath, size_t memoryBytes, const string& tempDir = "/tmp", Compare comp = Compare()) {
+    ExternalSortStats stats;
+
+    //Run formation.
+    size_t chunkRecords = max<size_t>(1, memoryBytes / (2*sizeof(Record)));
+    vector<Record> chunk(chunkRecords), scratch(chunkRecords);
+    vector<FileDescriptor> runFiles; //declared before the readers, so they're closed after the read-aheads end.
+
+    { //the input is closed at the end of this block.
+        FileDescriptor input(open(inputPath.c_str(), O_RDONLY));
+        if(input < 0) throw runtime_error("cannot open " + inputPath + ": " + strerror(errno));
+
+        for(off_t offset = 0; ; ) {
+            auto start = chrono::steady_clock::now();
+            size_t count = readAt(input, chunk.data(), chunkRecords*sizeof(Record), offset) / sizeof(Record);
+            stats.readSeconds += secondsSince(start);
+            if(count == 0) break;
+            offset += count*sizeof(Record);
+
+            start = chrono::steady_clock::now();
+            bottomUpMergeSort(chunk.begin(), scratch.begin(), count, comp);
+            stats.sortSeconds += secondsSince(start);
+
+            start = chrono::steady_clock::now();
+            string path = tempDir + "/external_sort_run_XXXXXX";
+            FileDescriptor run(mkstemp(&path[0]));
+            if(run < 0) throw runtime_error("cannot create a run in " + tempDir + ": " + strerror(errno));
+            unlink(path.c_str());
+            writeAll(run, chunk.data(), count*sizeof(Record));
+            runFiles.push_back(move(run));
+            stats.spillSeconds += secondsSince(start);
+
+            stats.bytes += count*sizeof(Record);
+        }
+    }
+
+    chunk = vector<Record>();
+    scratch = vector<Record>();
+    stats.runs = runFiles.size();
+
+    //Merge.
+    auto start = chrono::steady_clock::now();
+    FileDescriptor output(open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    if(output < 0) throw runtime_error("cannot open " + outputPath + ": " + strerror(errno));
+
+    size_t bufferRecords = max<size_t>(1, memoryBytes / ((2*runFiles.size() + 2)*sizeof(Record)));
+    vector<RunReader<Record>> runs;
+    runs.reserve(runFiles.size()); //readers must not move, as their read-ahead refers to them.
+    for(const FileDescriptor& run : runFiles) runs.emplace_back(run, bufferRecords);
+
+    if(!runs.empty()) {
+        RunWriter<Record> writer(output, bufferRecords);
+        LoserTree<Record, Compare> tree(runs, comp);
+
+        while(!tree.empty()) {
+            writer.push(tree.top());
+            tree.pop();
+        }
+
+        writer.finish();
+    }
+
+    for(RunReader<Record>& run : runs) {
+        if(run.pending.valid()) run.pending.wait();
+    }
+    stats.mergeSeconds = secondsSince(start);
+
+    return stats;
+}
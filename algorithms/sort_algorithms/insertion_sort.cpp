@@ -0,0 +1,57 @@
+/*
+Insertion sort sorts a sequence of values in monotonic order.
+Time Complexity: O(n^2), where n is the number of elements in the sequence.
+
+The algorithm keeps a sorted prefix of the sequence, which starts with only the first element.
+Each following element is inserted in the prefix:
+    While the element to it's left should come after it, that element is moved one position to the right.
+    The element is then placed in the position that was left open.
+After inserting the last element, the prefix is the whole sequence.
+
+
+Observations:
+    Insertion sort is stable, as an element never moves past an element equal to it.
+
+    It takes O(n + inversions), so it's fast for nearly sorted sequences.
+
+    For tiny sequences(tens of elements), it's faster than O(nlogn) sorts, which is why they often switch to it for small ranges.
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+//Sorting an array of integers in non-decreasing order.
+
+void insertionSort(vector<int>& array) {
+    for(int i = 1; i < (int)array.size(); i++) {
+        int value = array[i], j = i;
+
+        for(; j > 0 && array[j-1] > value; j--) {
+            array[j] = array[j-1];
+        }
+
+        array[j] = value;
+    }
+}
+
+//Sorting any random access range with a comparator.
+
+template<class Iterator, class Compare>
+void insertionSort(Iterator first, Iterator last, Compare comp) {
+    for(Iterator i = first; i != last; i++) {
+        auto value = move(*i);
+        Iterator j = i;
+
+        for(; j != first && comp(value, *(j-1)); j--) {
+            *j = move(*(j-1));
+        }
+
+        *j = move(value);
+    }
+}
@@ -9,40 +9,181 @@ The merge is done using two pointers, each iterating through one half.
 The smallest element being pointed to is added to the auxiliar array and it's pointer is incremented.
 If one of the pointers is pointing outside it's respective half, then the element in the other half is added.
 The final merged array is correctly sorted.
+
+
+Observations:
+    Merge sort is stable: when both pointed elements are equal, the one from the first half is added first, so equal elements keep their relative order.
+
+    The auxiliar array never needs more than n elements, so it can be allocated once, before sorting, and shared by every merge.
+    Allocating it inside each merge costs an allocation per merge, which dominates the running time for large inputs.
+
+    Bottom-up merge sort:
+        Instead of recursing, the sequence is seen as n/width sorted runs of size width, starting with width = 1.
+        Every pair of consecutive runs is merged, and width doubles, until a single run remains.
+        Each pass merges from the sequence into the auxiliar array, or the other way around, so nothing is copied back between passes.
+        For tiny runs, insertion sort is faster than merging, so the first runs are sorted with insertion sort instead of starting with width = 1.
+
+    Parallel merge sort:
+        Both halves are sorted in parallel(fork), and the current thread waits for both to be done(join) before merging them.
+        The final merges would run on a single thread, so the merge itself is split as well:
+            The output of a merge is split in p equal parts.
+            The first k elements of the output are the first i elements of the first half and the first k-i of the second half.
+            This i is the co-rank of k, and it's found with a binary search, as the first half's element i is among the first k iff it's <= the second half's element k-i-1.
+            With the co-ranks of the parts' borders, each part is an independent merge, done by a different thread.
 */
 
 //Implementation examples:
 
+#pragma once
+
+#include "insertion_sort.cpp"
 #include <vector>
+#include <iterator>
+#include <functional>
+#include <algorithm>
+#include <thread>
 
 using namespace std;
 
 //Sorting an array of integers in non-decreasing order.
 
-void merge(int left, int middle, int right, vector<int>& array) {
+void merge(int left, int middle, int right, vector<int>& array, vector<int>& aux) {
     int half1Index = left, half2Index = middle+1;
-    vector<int> aux(array.size());
 
-    for(int& x : aux) {
-        if((half2Index > right || array[half1Index] <= array[half2Index]) && half1Index < middle+1) {
-            x = array[half1Index];
+    for(int i = left; i <= right; i++) {
+        if(half2Index > right || (half1Index <= middle && array[half1Index] <= array[half2Index])) {
+            aux[i] = array[half1Index];
             half1Index++;
         }else {
-            x = array[half2Index];
+            aux[i] = array[half2Index];
             half2Index++;
         }
     }
 
-    for(int i = left, j = 0; i <= right; i++, j++) {
-        array[i] = aux[j];
+    for(int i = left; i <= right; i++) {
+        array[i] = aux[i];
     }
 }
 
-void mergeSort(int left, int right, vector<int>& array) {
+void mergeSort(int left, int right, vector<int>& array, vector<int>& aux) {
     if(left < right) {
         int middle = left + (right - left)/2;
-        mergeSort(left, middle, array);
-        mergeSort(middle+1, right, array);
-        merge(left, middle, right, array);
+        mergeSort(left, middle, array, aux);
+        mergeSort(middle+1, right, array, aux);
+        merge(left, middle, right, array, aux);
+    }
+}
+
+void mergeSort(int left, int right, vector<int>& array) {
+    vector<int> aux(array.size());
+    mergeSort(left, right, array, aux);
+}
+
+//Bottom-up merge sort of any random access range, with a scratch buffer allocated once.
+
+const int INSERTION_SORT_RUN = 32;
+
+//Merges the sorted ranges [first1,last1) and [first2,last2) into out, taking from the first range on ties.
+template<class InIterator, class OutIterator, class Compare>
+OutIterator mergeRuns(InIterator first1, InIterator last1, InIterator first2, InIterator last2, OutIterator out, Compare comp) {
+    while(first1 != last1 && first2 != last2) {
+        if(comp(*first2, *first1)) *out++ = move(*first2++);
+        else *out++ = move(*first1++);
+    }
+
+    out = move(first1, last1, out);
+    return move(first2, last2, out);
+}
+
+//Sorts [first,first+n) using scratch[0,n) as the auxiliar array.
+template<class Iterator, class ScratchIterator, class Compare>
+void bottomUpMergeSort(Iterator first, ScratchIterator scratch, long long n, Compare comp) {
+    for(long long i = 0; i < n; i += INSERTION_SORT_RUN) {
+        insertionSort(first + i, first + min(n, i + INSERTION_SORT_RUN), comp);
+    }
+
+    bool inScratch = false; //whether the current runs are in scratch or in the sequence.
+
+    for(long long width = INSERTION_SORT_RUN; width < n; width *= 2) {
+        for(long long i = 0; i < n; i += 2*width) {
+            long long middle = min(n, i + width), right = min(n, i + 2*width);
+
+            if(inScratch) mergeRuns(scratch + i, scratch + middle, scratch + middle, scratch + right, first + i, comp);
+            else mergeRuns(first + i, first + middle, first + middle, first + right, scratch + i, comp);
+        }
+
+        inScratch = !inScratch;
+    }
+
+    if(inScratch) move(scratch, scratch + n, first);
+}
+
+template<class Iterator, class Compare = less<>>
+void bottomUpMergeSort(Iterator first, Iterator last, Compare comp = Compare()) {
+    vector<typename iterator_traits<Iterator>::value_type> scratch(last - first);
+    bottomUpMergeSort(first, scratch.begin(), last - first, comp);
+}
+
+//Parallel merge sort, forking on halves and splitting the merges by co-rank.
+
+const long long PARALLEL_MIN_SIZE = 1 << 14; //smaller ranges are sorted sequentially.
+
+//Number of elements of a[0,na) among the first k elements of the stable merge of a and b.
+template<class Iterator, class Compare>
+long long coRank(long long k, Iterator a, long long na, Iterator b, long long nb, Compare comp) {
+    long long lo = max(0LL, k - nb), hi = min(k, na);
+
+    while(lo < hi) {
+        long long i = lo + (hi - lo)/2, j = k - i;
+
+        if(0 < j && !comp(b[j-1], a[i])) lo = i+1;
+        else hi = i;
+    }
+
+    return lo;
+}
+
+//Merges the sorted halves [0,middle) and [middle,n) of first into scratch and moves the result back, using threads threads.
+template<class Iterator, class ScratchIterator, class Compare>
+void parallelMerge(Iterator first, ScratchIterator scratch, long long middle, long long n, Compare comp, int threads) {
+    auto mergePart = [&](int part) {
+        long long k1 = n*part/threads, k2 = n*(part+1)/threads;
+        long long i1 = coRank(k1, first, middle, first + middle, n - middle, comp);
+        long long i2 = coRank(k2, first, middle, first + middle, n - middle, comp);
+
+        mergeRuns(first + i1, first + i2, first + middle + (k1 - i1), first + middle + (k2 - i2), scratch + k1, comp);
+    };
+
+    auto moveBack = [&](int part) {
+        long long k1 = n*part/threads, k2 = n*(part+1)/threads;
+        move(scratch + k1, scratch + k2, first + k1);
+    };
+
+    for(auto step : {function<void(int)>(mergePart), function<void(int)>(moveBack)}) {
+        vector<thread> workers;
+        for(int part = 1; part < threads; part++) workers.emplace_back(step, part);
+        step(0);
+        for(thread& worker : workers) worker.join();
     }
-}
\ No newline at end of file
+}
+
+template<class Iterator, class ScratchIterator, class Compare>
+void parallelMergeSort(Iterator first, ScratchIterator scratch, long long n, Compare comp, int threads) {
+    if(threads <= 1 || n < PARALLEL_MIN_SIZE) {
+        bottomUpMergeSort(first, scratch, n, comp);
+        return;
+    }
+
+    long long middle = n/2;
+    thread leftHalf([=] { parallelMergeSort(first, scratch, middle, comp, threads/2); });
+    parallelMergeSort(first + middle, scratch + middle, n - middle, comp, threads - threads/2);
+    leftHalf.join();
+
+    parallelMerge(first, scratch, middle, n, comp, threads);
+}
+
+template<class Iterator, class Compare = less<>>
+void parallelMergeSort(Iterator first, Iterator last, Compare comp = Compare(), int threads = thread::hardware_concurrency()) {
+    vector<typename iterator_traits<Iterator>::value_type> scratch(last - first);
+    parallelMergeSort(first, scratch.begin(), last - first, comp, max(1, threads));
+}
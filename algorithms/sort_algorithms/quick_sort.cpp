@@ -9,22 +9,56 @@ After doing this for every element on the sequence, the last position to have it
 Now, every value to the left of pivot should be to the left of it, and we can say the same for every value on the right.
 The same steps above are called recursively for the values on the left of pivot and to the right of pivot until left = right.
 At the end, every value to the left or right of any other value should be there, so the array is ordered.
+
+
+Observations:
+    With the last element as pivot, an already sorted sequence(or one with every element equal) makes every partition leave n-1 elements on one side, taking O(n^2).
+
+    Introsort is the quick sort used in practice, which avoids this and takes O(nlogn) in the worst case:
+        Pivot selection: the pivot is the median of the first, middle and last elements(median of 3).
+            For large ranges, it's the median of three such medians(ninther), which is much less likely to be a bad pivot.
+        Depth limit: if the recursion gets deeper than 2*logn, the pivots have been bad too often, and the range is sorted with heap sort instead.
+        Small ranges: ranges of a few elements are sorted with insertion sort, which is faster for them.
+        The recursion is only called for the smaller side, and the larger side is handled by the same call, so the stack depth is O(logn).
+
+    Block partitioning(BlockQuicksort):
+        In the usual partition, every comparison with the pivot is a branch that's taken about half of the time, so the cpu mispredicts it about half of the time.
+        Instead, the partition scans a block of elements from the left end and stores the offsets of the ones that belong to the right.
+        The comparison result is added to the count of offsets instead of being branched on: offsets[count] = i; count += (element >= pivot).
+        The same is done for a block from the right end, and then the stored elements of both blocks are swapped in pairs.
+
+    Many equal elements:
+        After partitioning, every element to the right of the pivot is >= pivot.
+        If a range's new pivot is equal to the element right before the range(the previous pivot), no element in the range is smaller than it.
+        Then, all elements equal to the pivot are moved to the left of the range, where they're already in their final position, and only the rest is sorted.
+        This makes sequences with few unique values take O(nlogk), where k is the number of unique values.
 */
 
+#pragma once
+
+#include "insertion_sort.cpp"
+#include "../instrumentation.cpp"
 #include <vector>
+#include <iterator>
+#include <functional>
+#include <algorithm>
 
 using namespace std;
 
 //Implementation examples:
 
 //Sorting an array of integers in non-decreasing order.
+//The Instrumentation policy counts the comparisons and swaps(see ../instrumentation.cpp).
 
-int partition(int left, int right, vector<int>& array) {
-    int pivot = array[right], lastLeft = -1;
+template<class Instrumentation>
+int partition(int left, int right, vector<int>& array, Instrumentation& instrumentation) {
+    int pivot = array[right], lastLeft = left-1;
 
-    for(int i = 0; i <= right; i++) {
-        if(array[i] <= array[right]) {
+    for(int i = left; i <= right; i++) {
+        instrumentation.comparison();
+        if(array[i] <= pivot) {
             lastLeft++;
+            instrumentation.swap();
             swap(array[i], array[lastLeft]);
         }
     }
@@ -32,10 +66,179 @@ int partition(int left, int right, vector<int>& array) {
     return lastLeft;
 }
 
-void quickSort(int left, int right, vector<int>& array) {
+template<class Instrumentation>
+void quickSort(int left, int right, vector<int>& array, Instrumentation& instrumentation) {
     if(left < right) {
-        int lastPivot = partition(left, right, array);
-        quickSort(left, lastPivot-1, array);
-        quickSort(lastPivot+1, right, array);
+        int lastPivot = partition(left, right, array, instrumentation);
+        quickSort(left, lastPivot-1, array, instrumentation);
+        quickSort(lastPivot+1, right, array, instrumentation);
+    }
+}
+
+int partition(int left, int right, vector<int>& array) {
+    NoInstrumentation none;
+    return partition(left, right, array, none);
+}
+
+void quickSort(int left, int right, vector<int>& array) {
+    NoInstrumentation none;
+    quickSort(left, right, array, none);
+}
+
+//Introsort of any random access range with a comparator.
+
+const int INTRO_SORT_INSERTION_SIZE = 24; //ranges up to this size are sorted with insertion sort.
+const int NINTHER_MIN_SIZE = 128; //ranges from this size on use the ninther as pivot.
+const int PARTITION_BLOCK = 64;
+
+template<class Iterator, class Compare>
+void siftDown(Iterator first, long long i, long long n, Compare comp) {
+    auto value = move(first[i]);
+
+    for(long long child = 2*i+1; child < n; i = child, child = 2*i+1) {
+        if(child+1 < n && comp(first[child], first[child+1])) child++;
+        if(!comp(value, first[child])) break;
+        first[i] = move(first[child]);
+    }
+
+    first[i] = move(value);
+}
+
+template<class Iterator, class Compare>
+void heapSort(Iterator first, Iterator last, Compare comp) {
+    long long n = last - first;
+
+    for(long long i = n/2 - 1; 0 <= i; i--) {
+        siftDown(first, i, n, comp);
+    }
+
+    for(long long end = n-1; 0 < end; end--) {
+        iter_swap(first, first + end);
+        siftDown(first, 0, end, comp);
+    }
+}
+
+//Sorts *a, *b and *c, so the median of the three ends up in b.
+template<class Iterator, class Compare>
+void sort3(Iterator a, Iterator b, Iterator c, Compare comp) {
+    if(comp(*b, *a)) iter_swap(a, b);
+    if(comp(*c, *b)) iter_swap(b, c);
+    if(comp(*b, *a)) iter_swap(a, b);
+}
+
+//Moves the median of 3 or the ninther of [first,last) to first.
+template<class Iterator, class Compare>
+void choosePivot(Iterator first, Iterator last, Compare comp) {
+    long long n = last - first;
+    Iterator middle = first + n/2;
+
+    if(n < NINTHER_MIN_SIZE) {
+        sort3(middle, first, last-1, comp);
+        return;
+    }
+
+    sort3(first, middle, last-1, comp);
+    sort3(first+1, middle-1, last-2, comp);
+    sort3(first+2, middle+1, last-3, comp);
+    sort3(middle-1, middle, middle+1, comp);
+    iter_swap(first, middle);
+}
+
+//Partitions [first,last) around the pivot *first. Returns the pivot's final position: elements before it are < pivot, and after it, >= pivot.
+template<class Iterator, class Compare>
+Iterator blockPartition(Iterator first, Iterator last, Compare comp) {
+    const auto& pivot = *first;
+    Iterator l = first+1, r = last; //[l,r) is yet to be partitioned.
+
+    unsigned char offsetsL[PARTITION_BLOCK], offsetsR[PARTITION_BLOCK];
+    int numL = 0, numR = 0, startL = 0, startR = 0;
+
+    while(r - l > 2*PARTITION_BLOCK) {
+        if(numL == 0) {
+            startL = 0;
+            for(int i = 0; i < PARTITION_BLOCK; i++) {
+                offsetsL[numL] = i;
+                numL += !comp(l[i], pivot);
+            }
+        }
+
+        if(numR == 0) {
+            startR = 0;
+            for(int i = 0; i < PARTITION_BLOCK; i++) {
+                offsetsR[numR] = i;
+                numR += comp(*(r-1-i), pivot);
+            }
+        }
+
+        int num = min(numL, numR);
+        for(int k = 0; k < num; k++) {
+            iter_swap(l + offsetsL[startL+k], r-1 - offsetsR[startR+k]);
+        }
+
+        numL -= num, numR -= num;
+        startL += num, startR += num;
+        if(numL == 0) l += PARTITION_BLOCK;
+        if(numR == 0) r -= PARTITION_BLOCK;
+    }
+
+    //Less than 2 blocks remain unpartitioned, and a block with pending offsets is simply partitioned again.
+    Iterator lastLeft = l;
+    for(Iterator it = l; it != r; it++) {
+        if(comp(*it, pivot)) iter_swap(it, lastLeft++);
+    }
+
+    iter_swap(first, lastLeft-1);
+    return lastLeft-1;
+}
+
+//Moves the elements equal to the pivot *first to the start of [first,last), given no element is < pivot. Returns the end of the equal elements.
+template<class Iterator, class Compare>
+Iterator partitionEqual(Iterator first, Iterator last, Compare comp) {
+    const auto& pivot = *first;
+    Iterator lastEqual = first+1;
+
+    for(Iterator it = first+1; it != last; it++) {
+        if(!comp(pivot, *it)) iter_swap(it, lastEqual++);
     }
-}
\ No newline at end of file
+
+    return lastEqual;
+}
+
+template<class Iterator, class Compare>
+void introSort(Iterator first, Iterator last, Compare comp, int depthLimit, bool leftmost) {
+    while(last - first > INTRO_SORT_INSERTION_SIZE) {
+        if(depthLimit == 0) {
+            heapSort(first, last, comp);
+            return;
+        }
+        depthLimit--;
+
+        choosePivot(first, last, comp);
+
+        if(!leftmost && !comp(*(first-1), *first)) {
+            first = partitionEqual(first, last, comp);
+            continue;
+        }
+
+        Iterator pivot = blockPartition(first, last, comp);
+
+        if(pivot - first < last - pivot) {
+            introSort(first, pivot, comp, depthLimit, leftmost);
+            first = pivot+1;
+            leftmost = false;
+        }else {
+            introSort(pivot+1, last, comp, depthLimit, false);
+            last = pivot;
+        }
+    }
+
+    insertionSort(first, last, comp);
+}
+
+template<class Iterator, class Compare = less<>>
+void introSort(Iterator first, Iterator last, Compare comp = Compare()) {
+    int depthLimit = 0;
+    for(long long n = last - first; n > 1; n /= 2) depthLimit += 2;
+
+    introSort(first, last, comp, depthLimit, true);
+}
@@ -0,0 +1,33 @@
+/*
+Thread helpers shared by the parallel algorithms and data structures(parallel radix sort, CSR graph builds, parallel graph traversals, sparse table builds).
+Time Complexity: O(threads) to start and join the threads, plus the work they do.
+
+runThreads(threads, f) runs f(t) for every t in [0,threads), each on it's own thread, and waits for all of them.
+The calling thread runs f(0) itself, so one thread starts nothing, and p threads only start p-1.
+
+Work over [0,count) is split in contiguous ranges, range t being [count*t/threads, count*(t+1)/threads):
+the ranges differ in size by at most one, and together they cover [0,count) exactly.
+
+
+Observations:
+    Starting and joining a thread takes tens of microseconds, so each caller picks how many threads are worth using for the work it has(e.g, at least some number of elements per thread).
+*/
+
+//Implementation examples:
+
+#pragma once
+
+#include <vector>
+#include <thread>
+
+using namespace std;
+
+//Runs f(t) for t in [0,threads), each on it's own thread(t = 0 on the calling one), and waits for all of them.
+
+template<class F>
+void runThreads(int threads, F f) {
+    vector<thread> workers;
+    for(int t = 1; t < threads; t++) workers.emplace_back(f, t);
+    f(0);
+    for(thread& worker : workers) worker.join();
+}
@@ -0,0 +1,302 @@
+/*
+Benchmark harness shared by the benchmark of each subsystem(sorts, searches, graphs and segment trees).
+
+Each benchmark runs a list of cases(an algorithm or data structure operation) on every combination of input and size, and reports one row per combination.
+A case is run a number of times(samples), and each sample is timed separately:
+    For algorithms that process the whole input at once(sorts, graph traversals), a sample is one run on a fresh copy of the input.
+    For queries(searches, segment tree operations), a sample is a batch of QUERY_BATCH queries, so the latency of a single query is measured without the timer dominating it.
+    Query benchmarks take QUERY_SAMPLES times as many samples, so the percentiles have enough samples to mean something.
+
+Reported columns:
+    benchmark, case, input, n: what was run. n is the number of elements, or of nodes for graphs.
+    elements: the elements processed per sample(e.g, n for a sort, the number of queries for a search, the number of edges for a graph traversal).
+    samples: the number of samples.
+    ns_per_element: the median time per element of the samples.
+    throughput: elements per second, from the median sample.
+    p50, p90, p99, min, max: percentiles of the time per element of the samples, in nanoseconds.
+
+Inputs:
+    random: uniform values in [0, 2^31).
+    sorted, reversed: random values in non-decreasing(non-increasing) order.
+    few-unique: uniform values among 16 distinct ones.
+    zipf: values drawn from a zipf distribution(value k with probability proportional to 1/k), so a few values are very frequent.
+    rmat: R-MAT graph(recursive matrix, the graph500 generator), with a skewed degree distribution like social and web graphs.
+    grid: 2D grid graph, where each node has edges to it's 4 neighbours, with a large diameter like road networks.
+
+Usage: <benchmark> [--sizes=1e3,1e6] [--inputs=random,zipf] [--filter=substring] [--samples=5] [--format=csv|json] [--threads=4] [--seed=1] [--output=file]
+Sizes can go from 10^3 to 10^8. Cases that are too slow for a size(e.g, quadratic sorts) skip it.
+
+
+Observations:
+    Results are printed as a table in csv, or as a json array of objects, so runs can be compared by a script to find regressions.
+
+    Every value computed by a case is passed to doNotOptimize, so the compiler can't remove the work being measured.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+//Options
+
+struct BenchmarkOptions {
+    vector<long long> sizes;
+    vector<string> inputs;
+    string filter;        //only cases whose name contains filter are run.
+    int samples = 5;
+    string format = "csv";
+    int threads = max(1u, thread::hardware_concurrency());
+    uint64_t seed = 1;
+    string output;        //empty for the standard output.
+
+    bool selected(const string& name) const { return name.find(filter) != string::npos; }
+};
+
+const int QUERY_BATCH = 1024, QUERY_SAMPLES = 20;
+
+inline vector<string> splitList(const string& list) {
+    vector<string> items;
+    size_t start = 0;
+
+    while(start <= list.size()) {
+        size_t end = list.find(',', start);
+        if(end == string::npos) end = list.size();
+        if(start < end) items.push_back(list.substr(start, end - start));
+        start = end+1;
+    }
+
+    return items;
+}
+
+inline BenchmarkOptions parseOptions(int argc, char** argv, vector<long long> defaultSizes, vector<string> defaultInputs) {
+    BenchmarkOptions options;
+    options.sizes = defaultSizes;
+    options.inputs = defaultInputs;
+
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        size_t equals = arg.find('=');
+        string key = arg.substr(0, equals), value = equals == string::npos ? "" : arg.substr(equals+1);
+
+        if(key == "--sizes") {
+            options.sizes.clear();
+            for(const string& size : splitList(value)) options.sizes.push_back(llround(stod(size)));
+        }else if(key == "--inputs") {
+            options.inputs = splitList(value);
+        }else if(key == "--filter") {
+            options.filter = value;
+        }else if(key == "--samples") {
+            options.samples = max(1, stoi(value));
+        }else if(key == "--format" && (value == "csv" || value == "json")) {
+            options.format = value;
+        }else if(key == "--threads") {
+            options.threads = max(1, stoi(value));
+        }else if(key == "--seed") {
+            options.seed = stoull(value);
+        }else if(key == "--output") {
+            options.output = value;
+        }else {
+            cerr << "usage: " << argv[0] << " [--sizes=1e3,1e6] [--inputs=random,zipf] [--filter=substring] [--samples=5]"
+                 << " [--format=csv|json] [--threads=N] [--seed=S] [--output=file]\n";
+            exit(arg == "--help" ? 0 : 1);
+        }
+    }
+
+    return options;
+}
+
+//Timing
+
+template<class T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+//Times run() samples times, calling setup() before each sample, untimed. Returns the seconds of each sample.
+template<class Setup, class Run>
+vector<double> measure(int samples, Setup setup, Run run) {
+    vector<double> seconds;
+
+    for(int i = 0; i < samples; i++) {
+        setup();
+        auto start = chrono::steady_clock::now();
+        run();
+        seconds.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+
+    return seconds;
+}
+
+//Reporting
+
+struct Reporter {
+    ostream* out;
+    ofstream file;
+    string format;
+    bool first = true;
+
+    Reporter(const BenchmarkOptions& options) : out(&cout), format(options.format) {
+        if(!options.output.empty()) {
+            file.open(options.output);
+            if(!file) throw runtime_error("cannot open " + options.output);
+            out = &file;
+        }
+
+        if(format == "csv") *out << "benchmark,case,input,n,elements,samples,ns_per_element,throughput,p50,p90,p99,min,max\n";
+        else *out << "[";
+    }
+
+    ~Reporter() {
+        if(format == "json") *out << (first ? "]\n" : "\n]\n");
+        out->flush();
+    }
+
+    //seconds[i] is the time of sample i, each processing elements elements.
+    void report(const string& benchmark, const string& name, const string& input, long long n, long long elements, vector<double> seconds) {
+        sort(seconds.begin(), seconds.end());
+        auto perElement = [&](double q) { return seconds[min<size_t>(seconds.size()-1, q*seconds.size())] * 1e9 / max(1LL, elements); };
+
+        double median = perElement(0.5);
+        double throughput = median > 0 ? 1e9/median : 0;
+        double values[] = {median, throughput, perElement(0.5), perElement(0.9), perElement(0.99), perElement(0), perElement(1)};
+
+        char row[512];
+        if(format == "csv") {
+            snprintf(row, sizeof(row), "%s,%s,%s,%lld,%lld,%zu,%.4g,%.6g,%.4g,%.4g,%.4g,%.4g,%.4g\n",
+                     benchmark.c_str(), name.c_str(), input.c_str(), n, elements, seconds.size(),
+                     values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+        }else {
+            snprintf(row, sizeof(row), "%s\n  {\"benchmark\": \"%s\", \"case\": \"%s\", \"input\": \"%s\", \"n\": %lld, \"elements\": %lld, \"samples\": %zu, "
+                     "\"ns_per_element\": %.4g, \"throughput\": %.6g, \"p50\": %.4g, \"p90\": %.4g, \"p99\": %.4g, \"min\": %.4g, \"max\": %.4g}",
+                     first ? "" : ",", benchmark.c_str(), name.c_str(), input.c_str(), n, elements, seconds.size(),
+                     values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+        }
+
+        first = false;
+        *out << row;
+        out->flush();
+    }
+};
+
+//Input generators
+
+//Zipf distribution over 1..k with exponent s, sampled by binary search on it's cumulative distribution.
+struct ZipfDistribution {
+    vector<double> cdf;
+
+    ZipfDistribution(long long k, double s = 1.0) : cdf(k) {
+        double sum = 0;
+        for(long long i = 0; i < k; i++) cdf[i] = sum += 1/pow(i+1, s);
+        for(double& c : cdf) c /= sum;
+    }
+
+    template<class Rng>
+    long long operator()(Rng& rng) {
+        double u = uniform_real_distribution<double>(0, 1)(rng);
+        return lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin() + 1;
+    }
+};
+
+const long long ZIPF_MAX_VALUES = 1 << 20; //zipf values are in [1, min(n, ZIPF_MAX_VALUES)], to bound the table's memory.
+
+inline vector<int> generateKeys(const string& input, long long n, uint64_t seed) {
+    mt19937_64 rng(seed);
+    vector<int> keys(n);
+
+    if(input == "few-unique") {
+        vector<int> values(16);
+        for(int& v : values) v = rng() % INT32_MAX;
+        for(int& key : keys) key = values[rng() % values.size()];
+    }else if(input == "zipf") {
+        ZipfDistribution zipf(max(1LL, min(n, ZIPF_MAX_VALUES)));
+        for(int& key : keys) key = zipf(rng);
+    }else {
+        for(int& key : keys) key = rng() % INT32_MAX;
+        if(input == "sorted") sort(keys.begin(), keys.end());
+        else if(input == "reversed") sort(keys.rbegin(), keys.rend());
+        else if(input != "random") throw invalid_argument("unknown input " + input);
+    }
+
+    return keys;
+}
+
+struct EdgeList {
+    int n = 0;
+    vector<pair<int,int>> edges;
+    vector<int> weights; //uniform in [1, 255].
+};
+
+//R-MAT graph with 2^scale nodes and edgeFactor*2^scale edges, with graph500's probabilities. Node ids are shuffled, so high degree nodes aren't all at the start.
+inline EdgeList rmatGraph(int scale, int edgeFactor, uint64_t seed, double a = 0.57, double b = 0.19, double c = 0.19) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> uniform(0, 1);
+
+    EdgeList graph;
+    graph.n = 1 << scale;
+    vector<int> relabel(graph.n);
+    for(int u = 0; u < graph.n; u++) relabel[u] = u;
+    shuffle(relabel.begin(), relabel.end(), rng);
+
+    long long m = (long long)edgeFactor << scale;
+    graph.edges.reserve(m);
+    for(long long i = 0; i < m; i++) {
+        int u = 0, v = 0;
+
+        for(int bit = 0; bit < scale; bit++) {
+            double r = uniform(rng);
+            int right = r >= a && (r < a+b || a+b+c <= r);
+            int down = r >= a+b;
+            u = 2*u + down, v = 2*v + right;
+        }
+
+        graph.edges.emplace_back(relabel[u], relabel[v]);
+    }
+
+    graph.weights.resize(m);
+    for(int& w : graph.weights) w = rng() % 255 + 1;
+    return graph;
+}
+
+//rows x cols grid, with edges in both directions between neighbours.
+inline EdgeList gridGraph(int rows, int cols, uint64_t seed) {
+    mt19937_64 rng(seed);
+
+    EdgeList graph;
+    graph.n = rows*cols;
+    for(int r = 0; r < rows; r++) {
+        for(int c = 0; c < cols; c++) {
+            int u = r*cols + c;
+            if(c+1 < cols) graph.edges.emplace_back(u, u+1), graph.edges.emplace_back(u+1, u);
+            if(r+1 < rows) graph.edges.emplace_back(u, u+cols), graph.edges.emplace_back(u+cols, u);
+        }
+    }
+
+    graph.weights.resize(graph.edges.size());
+    for(int& w : graph.weights) w = rng() % 255 + 1;
+    return graph;
+}
+
+//Graph with about n nodes: R-MAT with 2^ceil(log2(n)) nodes and 16 edges per node, or a sqrt(n) x sqrt(n) grid.
+inline EdgeList generateGraph(const string& input, long long n, uint64_t seed) {
+    if(input == "rmat") return rmatGraph(max(1, (int)ceil(log2((double)n))), 16, seed);
+    if(input == "grid") {
+        int side = max(1, (int)llround(sqrt((double)n)));
+        return gridGraph(side, side, seed);
+    }
+
+    throw invalid_argument("unknown graph input " + input);
+}
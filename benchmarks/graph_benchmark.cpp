@@ -0,0 +1,107 @@
+/*
+Benchmark of the graph algorithms in algorithms/graph_algorithms, on R-MAT and grid graphs with about n nodes(see benchmark.cpp).
+Each sample runs the algorithm once on the whole graph, and elements is the number of edges.
+
+Node 0 is swapped with the node of largest out degree, as the algorithms that always start at node 0 would otherwise often start at an isolated node of the R-MAT graph.
+The recursive dfs1 and tarjan only run up to RECURSIVE_MAX_SIZE nodes, as deeper graphs overflow the call stack.
+multiSourceBfsHistograms runs a bfs from MULTI_SOURCES sources at once, so it's elements are MULTI_SOURCES times the edges.
+*/
+
+#include "benchmark.cpp"
+#include "../algorithms/graph_algorithms/csr_graph.cpp"
+#include "../algorithms/graph_algorithms/breadth_first_search.cpp"
+#include "../algorithms/graph_algorithms/depth_first_search.cpp"
+#include "../algorithms/graph_algorithms/dijkstra_algorithm.cpp"
+#include "../algorithms/graph_algorithms/delta_stepping.cpp"
+#include "../algorithms/graph_algorithms/tarjan_algorithm.cpp"
+#include "../algorithms/graph_algorithms/parallel_scc.cpp"
+#include <functional>
+
+using namespace std;
+
+const long long RECURSIVE_MAX_SIZE = 10000;
+const int MULTI_SOURCES = 64;
+
+//Swaps the labels of node 0 and the node with the largest out degree.
+void relabelSource(EdgeList& edges) {
+    vector<int> degree(edges.n, 0);
+    for(auto [u, v] : edges.edges) degree[u]++;
+
+    int hub = max_element(degree.begin(), degree.end()) - degree.begin();
+    auto relabel = [hub](int u) { return u == hub ? 0 : u == 0 ? hub : u; };
+    for(auto& [u, v] : edges.edges) u = relabel(u), v = relabel(v);
+}
+
+struct GraphCase {
+    string name;
+    function<void()> run;
+    long long maxSize = LLONG_MAX;
+    long long edgeMultiplier = 1;
+};
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options = parseOptions(argc, argv, {1000, 100000, 1000000}, {"rmat", "grid"});
+    Reporter reporter(options);
+
+    for(const string& input : options.inputs) {
+        for(long long size : options.sizes) {
+            EdgeList edges = generateGraph(input, size, options.seed);
+            relabelSource(edges);
+
+            CsrGraph<int> graph = buildCsrGraph(edges.n, edges.edges, edges.weights, options.threads);
+            CsrGraph<int> incoming = graph.transpose(options.threads);
+            SccResult sccs = stronglyConnectedComponents(graph);
+            int n = graph.size(), threads = options.threads;
+            DfsWorkspace dfs(n);
+
+            vector<int> sources(MULTI_SOURCES);
+            for(int i = 0; i < MULTI_SOURCES; i++) sources[i] = (long long)i*n/MULTI_SOURCES;
+
+            vector<GraphCase> cases = {
+                {"buildCsrGraph", [&] { doNotOptimize(buildCsrGraph(edges.n, edges.edges, edges.weights, threads)); }},
+                {"transpose", [&] { doNotOptimize(graph.transpose(threads)); }},
+                {"bfs", [&] { bfs(graph); }},
+                {"dfs1", [&] {
+                    vector<bool> vis(n, false);
+                    for(int u = 0; u < n; u++) {
+                        if(!vis[u]) dfs1(u, graph, vis);
+                    }
+                    doNotOptimize(vis);
+                }, RECURSIVE_MAX_SIZE},
+                {"dfs2", [&] { dfs2(graph); }},
+                {"iterativeDfs", [&] {
+                    DfsVisitor visitor;
+                    iterativeDfs(graph, dfs, visitor);
+                    doNotOptimize(dfs.post);
+                }},
+                {"directionOptimizingBfs", [&] { doNotOptimize(directionOptimizingBfs(graph, 0, &incoming, threads)); }},
+                {"multiSourceBfsHistograms", [&] { doNotOptimize(multiSourceBfsHistograms(graph, sources, threads)); }, LLONG_MAX, MULTI_SOURCES},
+                {"dijkstra", [&] { dijkstra(graph.weighted()); }},
+                {"shortestPaths<IndexedDaryHeap>", [&] { doNotOptimize(shortestPaths<IndexedDaryHeap<ll>>(graph.weighted(), {0})); }},
+                {"shortestPaths<RadixHeap>", [&] { doNotOptimize(shortestPaths<RadixHeap<ll>>(graph.weighted(), {0})); }},
+                {"deltaStepping", [&] { doNotOptimize(deltaStepping(graph, 0, 0, threads)); }},
+                {"tarjan", [&] {
+                    vector<int> lowlink(n), time(n, 0);
+                    vector<bool> onStack(n, false);
+                    stack<int> s;
+                    int currTime = 1;
+
+                    for(int u = 0; u < n; u++) {
+                        if(!time[u]) tarjan(u, currTime, lowlink, time, graph, s, onStack), currTime++;
+                    }
+                    doNotOptimize(lowlink);
+                }, RECURSIVE_MAX_SIZE},
+                {"stronglyConnectedComponents", [&] { doNotOptimize(stronglyConnectedComponents(graph)); }},
+                {"parallelScc", [&] { doNotOptimize(parallelScc(graph, &incoming, threads)); }},
+                {"condensation", [&] { doNotOptimize(condensation(graph, sccs)); }},
+            };
+
+            for(const GraphCase& c : cases) {
+                if(!options.selected(c.name) || n > c.maxSize) continue;
+
+                vector<double> seconds = measure(options.samples, [] {}, c.run);
+                reporter.report("graph", c.name, input, n, graph.edges()*c.edgeMultiplier, seconds);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+/*
+Benchmark of the searches in algorithms/search_algorithms, on a sorted array of n random values.
+Each sample is a batch of queries, and elements is the number of queries in it.
+
+The queries are values of the array, at positions given by the input:
+    random: uniform positions.
+    sorted, reversed: uniform positions, in increasing(decreasing) order, so consecutive searches follow similar paths.
+    few-unique: 16 positions, so the same few paths are always in cache.
+    zipf: zipf distributed positions, so a few positions are very frequent.
+
+Linear searches take O(n) per query, so they use batches of LINEAR_BATCH queries, and only run up to LINEAR_MAX_SIZE.
+
+The vectorized linear searches are also measured as full scans(benchmark linear_scan) of an unsorted array of SCAN_SIZE values given by the input, larger than the caches, whatever the sizes:
+    elements is the number of bytes scanned, so throughput is in bytes per second, and 1/ns_per_element is in GB/s.
+    find and findAny look for values that aren't in the array, so they scan all of it, and count and findAll look for the value in the middle of the array.
+The layouts' build time is reported as well, with elements = n.
+std::lower_bound is included as a baseline.
+*/
+
+#include "benchmark.cpp"
+#include "../algorithms/search_algorithms/binary_search.cpp"
+#include "../algorithms/search_algorithms/linear_search.cpp"
+#include <functional>
+
+using namespace std;
+
+const int LINEAR_BATCH = 16;
+const long long LINEAR_MAX_SIZE = 1000000;
+const long long SCAN_SIZE = 1 << 24;
+
+//Queries at positions of the array given by the input.
+vector<int> generateQueries(const vector<int>& array, const string& input, int count, uint64_t seed) {
+    vector<int> positions = generateKeys(input == "zipf" || input == "few-unique" ? input : "random", count, seed);
+    for(int& p : positions) p = p % array.size();
+
+    if(input == "sorted") sort(positions.begin(), positions.end());
+    if(input == "reversed") sort(positions.rbegin(), positions.rend());
+
+    vector<int> queries(count);
+    for(int i = 0; i < count; i++) queries[i] = array[positions[i]];
+    return queries;
+}
+
+struct SearchCase {
+    string name;
+    function<long long(const vector<int>& queries)> run; //answers every query, returning a checksum of the answers.
+    bool linear = false;
+};
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options = parseOptions(argc, argv, {1000, 100000, 10000000}, {"random", "sorted", "few-unique", "zipf"});
+    Reporter reporter(options);
+
+    for(const string& input : options.inputs) {
+        //Full scans, at a fixed size.
+        vector<int> scanned = generateKeys(input, SCAN_SIZE, options.seed+2);
+        int target = scanned[SCAN_SIZE/2];
+        vector<int> absent = {-1, -2, -3, -4, -5, -6, -7, -8};
+        vector<long long> positions;
+
+        vector<pair<string, function<long long()>>> scans = {
+            {"linearSearch", [&] { return (long long)linearSearch(-1, scanned); }},
+            {"vectorizedFind", [&] { return vectorizedFind(-1, scanned); }},
+            {"vectorizedCount", [&] { return vectorizedCount(target, scanned); }},
+            {"vectorizedFindAll", [&] {
+                vectorizedFindAll(target, scanned, positions);
+                return (long long)positions.size();
+            }},
+            {"vectorizedFindAny", [&] { return vectorizedFindAny(absent, scanned); }},
+        };
+
+        for(auto& [name, scan] : scans) {
+            if(!options.selected(name)) continue;
+            vector<double> seconds = measure(options.samples, [] {}, [&] { doNotOptimize(scan()); });
+            reporter.report("linear_scan", name, input, SCAN_SIZE, SCAN_SIZE*sizeof(int), seconds);
+        }
+
+        for(long long n : options.sizes) {
+            vector<int> array = generateKeys("random", n, options.seed);
+            sort(array.begin(), array.end());
+
+            //Build times.
+            for(string name : {"EytzingerIndex::build", "STreeIndex::build"}) {
+                if(!options.selected(name)) continue;
+
+                vector<double> seconds = measure(options.samples, [] {}, [&] {
+                    if(name == "EytzingerIndex::build") doNotOptimize(EytzingerIndex<int>(array));
+                    else doNotOptimize(STreeIndex<int>(array));
+                });
+
+                reporter.report("search", name, input, n, n, seconds);
+            }
+
+            EytzingerIndex<int> eytzinger(array);
+            STreeIndex<int> stree(array);
+            vector<int> out;
+
+            auto each = [](auto search) {
+                return [search](const vector<int>& queries) {
+                    long long sum = 0;
+                    for(int q : queries) sum += search(q);
+                    return sum;
+                };
+            };
+
+            vector<SearchCase> cases = {
+                {"binarySearch1", each([&](int q) { return binarySearch1(q, array); })},
+                {"binarySearch2", each([&](int q) { return binarySearch2(q, array); })},
+                {"binarySearch3", each([&](int q) { return binarySearch3(q, array); })},
+                {"std::lower_bound", each([&](int q) { return lower_bound(array.begin(), array.end(), q) - array.begin(); })},
+                {"EytzingerIndex::lowerBound", each([&](int q) { return eytzinger.lowerBound(q); })},
+                {"EytzingerIndex::lowerBoundBatch", [&](const vector<int>& queries) {
+                    eytzinger.lowerBoundBatch(queries, out);
+                    return (long long)out.back();
+                }},
+                {"STreeIndex::lowerBound", each([&](int q) { return stree.lowerBound(q); })},
+                {"STreeIndex::lowerBoundBatch", [&](const vector<int>& queries) {
+                    stree.lowerBoundBatch(queries, out);
+                    return (long long)out.back();
+                }},
+                {"linearSearch", each([&](int q) { return linearSearch(q, array); }), true},
+                {"vectorizedFind", each([&](int q) { return vectorizedFind(q, array); }), true},
+            };
+
+            for(const SearchCase& c : cases) {
+                if(!options.selected(c.name) || (c.linear && n > LINEAR_MAX_SIZE)) continue;
+
+                int batch = c.linear ? LINEAR_BATCH : QUERY_BATCH, samples = options.samples*QUERY_SAMPLES;
+                vector<int> all = generateQueries(array, input, batch*samples, options.seed+1), queries;
+                int sample = 0;
+
+                vector<double> seconds = measure(samples, [&] {
+                    queries.assign(all.begin() + sample*batch, all.begin() + (sample+1)*batch);
+                    sample++;
+                }, [&] {
+                    doNotOptimize(c.run(queries));
+                });
+
+                reporter.report("search", c.name, input, n, batch, seconds);
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+Benchmark of the segment trees in data_structures, and of the sparse tables that answer the same static queries, on arrays of n values given by the input(see benchmark.cpp).
+Builds are timed once per sample with elements = n, and operations in batches of queries, with elements = the number of operations.
+
+Query ranges are uniform random intervals [l,r], and updates set uniform random positions to random values.
+The persistent segment tree only runs up to PERSISTENT_MAX_SIZE, as every update adds logn nodes that are never freed.
+The dynamic segment tree holds the values at n random 64 bit keys, and position i of an operation refers to the i-th smallest key.
+It only runs up to DYNAMIC_MAX_SIZE, as it's built with n separate sets.
+*/
+
+#include "benchmark.cpp"
+#include "../data_structures/segment_tree.cpp"
+#include "../data_structures/wide_segment_tree.cpp"
+#include "../data_structures/persistent_segment_tree.cpp"
+#include "../data_structures/sparse_table.cpp"
+#include "../data_structures/dynamic_segment_tree.cpp"
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+const long long PERSISTENT_MAX_SIZE = 1000000;
+const long long DYNAMIC_MAX_SIZE = 1000000;
+
+struct Operation {
+    int l, r;
+    long long value;
+};
+
+struct SegmentTreeCase {
+    string name;
+    function<long long(const vector<Operation>&)> run; //runs every operation, returning a checksum of the answers.
+    long long maxSize = LLONG_MAX;
+};
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options = parseOptions(argc, argv, {1000, 100000, 10000000}, {"random", "sorted", "zipf"});
+    Reporter reporter(options);
+
+    for(const string& input : options.inputs) {
+        for(long long size : options.sizes) {
+            int n = size;
+            vector<int> keys = generateKeys(input, n, options.seed);
+            vector<ll> values(keys.begin(), keys.end());
+
+            //Builds.
+            vector<pair<string, function<void()>>> builds = {
+                {"SegTree<Sum>::build", [&] { doNotOptimize(SegTree<ll, SumMonoid<ll>>(values.begin(), values.end())); }},
+                {"LazySegTree<AffineSum>::build", [&] { doNotOptimize(LazySegTree<ll, SumMonoid<ll>, AffineSumAction<ll>>(values)); }},
+                {"WideSegTree<Min>::build", [&] { doNotOptimize(WideSegTree<int, MinMonoid<int>>(keys)); }},
+                {"SparseTable<Min>::build", [&] { doNotOptimize(SparseTable<int, MinMonoid<int>>(keys, options.threads)); }},
+                {"BlockRmq::build", [&] { doNotOptimize(BlockRmq<int>(keys, options.threads)); }},
+            };
+
+            for(auto& [name, build] : builds) {
+                if(!options.selected(name)) continue;
+                reporter.report("segment_tree", name, input, n, n, measure(options.samples, [] {}, build));
+            }
+
+            SegTree<ll, SumMonoid<ll>> sum(values.begin(), values.end());
+            SegTree<int, MinMonoid<int>> minimum(keys.begin(), keys.end());
+            LazySegTree<ll, SumMonoid<ll>, AffineSumAction<ll>> lazy(values);
+            WideSegTree<int, MinMonoid<int>> wide(keys);
+            SparseTable<int, MinMonoid<int>> sparse(keys, options.threads);
+            BlockRmq<int> rmq(keys, options.threads);
+            unique_ptr<PersistentSegTree<ll, SumMonoid<ll>>> persistent;
+            if(n <= PERSISTENT_MAX_SIZE) persistent = make_unique<PersistentSegTree<ll, SumMonoid<ll>>>(values);
+
+            mt19937_64 keyRng(options.seed+2);
+            vector<uint64_t> sparseKeys(n <= DYNAMIC_MAX_SIZE ? n : 0);
+            for(uint64_t& key : sparseKeys) key = keyRng();
+            sort(sparseKeys.begin(), sparseKeys.end());
+
+            DynamicSegTree<ll, SumMonoid<ll>> dynamic(sparseKeys.size());
+            for(size_t i = 0; i < sparseKeys.size(); i++) dynamic.set(sparseKeys[i], values[i]);
+
+            vector<pii> ranges;
+            vector<ll> answers;
+
+            auto each = [](auto operation) {
+                return [operation](const vector<Operation>& operations) {
+                    long long sum = 0;
+                    for(const Operation& op : operations) sum += operation(op);
+                    return sum;
+                };
+            };
+
+            vector<SegmentTreeCase> cases = {
+                {"SegTree<Sum>::query", each([&](const Operation& op) { return sum.query(op.l, op.r); })},
+                {"SegTree<Sum>::set", each([&](const Operation& op) { sum.set(op.l, op.value); return 0LL; })},
+                {"SegTree<Sum>::queryBatch", [&](const vector<Operation>& operations) {
+                    ranges.resize(operations.size());
+                    for(size_t i = 0; i < operations.size(); i++) ranges[i] = {operations[i].l, operations[i].r};
+                    sum.queryBatch(ranges, answers);
+                    return answers.back();
+                }},
+                {"SegTree<Min>::query", each([&](const Operation& op) { return (ll)minimum.query(op.l, op.r); })},
+                {"LazySegTree<AffineSum>::query", each([&](const Operation& op) { return lazy.query(op.l, op.r); })},
+                {"LazySegTree<AffineSum>::add", each([&](const Operation& op) { lazy.add(op.l, op.r, op.value % 16); return 0LL; })},
+                {"WideSegTree<Min>::query", each([&](const Operation& op) { return (ll)wide.query(op.l, op.r); })},
+                {"WideSegTree<Min>::set", each([&](const Operation& op) { wide.set(op.l, op.value); return 0LL; })},
+                {"SparseTable<Min>::query", each([&](const Operation& op) { return (ll)sparse.query(op.l, op.r); })},
+                {"BlockRmq::argmin", each([&](const Operation& op) { return (ll)rmq.argmin(op.l, op.r); })},
+                {"PersistentSegTree<Sum>::set", each([&](const Operation& op) {
+                    return (ll)persistent->set(persistent->versions()-1, op.l, op.value);
+                }), PERSISTENT_MAX_SIZE},
+                {"PersistentSegTree<Sum>::query", each([&](const Operation& op) {
+                    return persistent->query(op.value % persistent->versions(), op.l, op.r);
+                }), PERSISTENT_MAX_SIZE},
+                {"DynamicSegTree<Sum>::set", each([&](const Operation& op) {
+                    dynamic.set(sparseKeys[op.l], op.value);
+                    return 0LL;
+                }), DYNAMIC_MAX_SIZE},
+                {"DynamicSegTree<Sum>::query", each([&](const Operation& op) {
+                    return dynamic.query(sparseKeys[op.l], sparseKeys[op.r]);
+                }), DYNAMIC_MAX_SIZE},
+            };
+
+            mt19937_64 rng(options.seed+1);
+            int samples = options.samples*QUERY_SAMPLES;
+            vector<Operation> all(QUERY_BATCH*samples), operations;
+            for(Operation& op : all) {
+                op.l = rng() % n, op.r = rng() % n, op.value = rng() % INT32_MAX;
+                if(op.r < op.l) swap(op.l, op.r);
+            }
+
+            for(const SegmentTreeCase& c : cases) {
+                if(!options.selected(c.name) || n > c.maxSize) continue;
+                int sample = 0;
+
+                vector<double> seconds = measure(samples, [&] {
+                    operations.assign(all.begin() + sample*QUERY_BATCH, all.begin() + (sample+1)*QUERY_BATCH);
+                    sample++;
+                }, [&] {
+                    doNotOptimize(c.run(operations));
+                });
+
+                reporter.report("segment_tree", c.name, input, n, QUERY_BATCH, seconds);
+            }
+        }
+    }
+}
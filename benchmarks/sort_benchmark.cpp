@@ -0,0 +1,95 @@
+/*
+Benchmark of the sorting algorithms in algorithms/sort_algorithms, on every input of benchmark.cpp except the graphs.
+Each sample sorts a fresh copy of the input, and elements is the number of values sorted.
+
+The quadratic sorts, and the quickSort with the last element as pivot on inputs where it's quadratic(sorted, reversed and inputs with many repeated values), only run up to QUADRATIC_MAX_SIZE.
+countingSort only runs when the range of values is at most a few times n, as it allocates one counter per value.
+std::sort and std::stable_sort are included as baselines.
+radixSort and std::sort also sort 64 bit keys(ll), made from the input's keys in the high bits.
+*/
+
+#include "benchmark.cpp"
+#include "../algorithms/sort_algorithms/bubble_sort.cpp"
+#include "../algorithms/sort_algorithms/insertion_sort.cpp"
+#include "../algorithms/sort_algorithms/merge_sort.cpp"
+#include "../algorithms/sort_algorithms/quick_sort.cpp"
+#include "../algorithms/sort_algorithms/counting_sort.cpp"
+#include <functional>
+
+using namespace std;
+using ll = long long;
+
+const long long QUADRATIC_MAX_SIZE = 20000;
+
+struct SortCase {
+    string name;
+    function<void(vector<int>&, int)> sort; //sorts the array with the given number of threads.
+    function<bool(const string&, long long)> runs = [](const string&, long long) { return true; }; //whether the case runs on an input of size n.
+};
+
+bool valueRangeAtMost(const vector<int>& keys, long long range) {
+    if(keys.empty()) return true;
+    auto [low, high] = minmax_element(keys.begin(), keys.end());
+    return (long long)*high - *low < range;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options = parseOptions(argc, argv, {1000, 10000, 100000, 1000000, 10000000}, {"random", "sorted", "reversed", "few-unique", "zipf"});
+    Reporter reporter(options);
+
+    auto quadratic = [](const string&, long long n) { return n <= QUADRATIC_MAX_SIZE; };
+    auto lastPivot = [](const string& input, long long n) { return input == "random" || n <= QUADRATIC_MAX_SIZE; };
+
+    vector<SortCase> cases = {
+        {"bubbleSort", [](vector<int>& a, int) { bubbleSort(a); }, quadratic},
+        {"insertionSort", [](vector<int>& a, int) { insertionSort(a); }, quadratic},
+        {"mergeSort", [](vector<int>& a, int) { mergeSort(0, (int)a.size()-1, a); }},
+        {"quickSort", [](vector<int>& a, int) { quickSort(0, (int)a.size()-1, a); }, lastPivot},
+        {"countingSort", [](vector<int>& a, int) {
+            auto [low, high] = minmax_element(a.begin(), a.end());
+            countingSort(*low, *high, a);
+        }},
+        {"bottomUpMergeSort", [](vector<int>& a, int) { bottomUpMergeSort(a.begin(), a.end()); }},
+        {"parallelMergeSort", [](vector<int>& a, int threads) { parallelMergeSort(a.begin(), a.end(), less<>(), threads); }},
+        {"introSort", [](vector<int>& a, int) { introSort(a.begin(), a.end()); }},
+        {"radixSort", [](vector<int>& a, int threads) { radixSort(a, threads); }},
+        {"std::sort", [](vector<int>& a, int) { std::sort(a.begin(), a.end()); }},
+        {"std::stable_sort", [](vector<int>& a, int) { std::stable_sort(a.begin(), a.end()); }},
+    };
+
+    for(const string& input : options.inputs) {
+        for(long long n : options.sizes) {
+            vector<int> keys = generateKeys(input, n, options.seed), array;
+
+            for(const SortCase& c : cases) {
+                if(!options.selected(c.name) || !c.runs(input, n)) continue;
+                if(c.name == "countingSort" && !valueRangeAtMost(keys, 4*n + 1024)) continue;
+
+                vector<double> seconds = measure(options.samples, [&] { array = keys; }, [&] {
+                    c.sort(array, options.threads);
+                    doNotOptimize(array);
+                });
+
+                if(!is_sorted(array.begin(), array.end())) cerr << c.name << " didn't sort " << input << " of size " << n << "\n";
+                reporter.report("sort", c.name, input, n, n, seconds);
+            }
+
+            //64 bit keys(ll), spread over the whole range so every radix pass does work.
+            vector<ll> wideKeys(keys.size()), wideArray;
+            for(size_t i = 0; i < keys.size(); i++) wideKeys[i] = (ll)keys[i] << 32 ^ (ll)(i * 0x9E3779B97F4A7C15ULL);
+
+            for(string name : {"radixSort<ll>", "std::sort<ll>"}) {
+                if(!options.selected(name)) continue;
+
+                vector<double> seconds = measure(options.samples, [&] { wideArray = wideKeys; }, [&] {
+                    if(name == "radixSort<ll>") radixSort(wideArray, options.threads);
+                    else std::sort(wideArray.begin(), wideArray.end());
+                    doNotOptimize(wideArray);
+                });
+
+                if(!is_sorted(wideArray.begin(), wideArray.end())) cerr << name << " didn't sort " << input << " of size " << n << "\n";
+                reporter.report("sort", name, input, n, n, seconds);
+            }
+        }
+    }
+}
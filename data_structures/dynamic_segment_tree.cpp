@@ -0,0 +1,155 @@
+/*
+Dynamic segment tree is a segment tree over the whole range of 64 bit keys, [0, 2^64), where only the nodes above keys that were set exist.
+Time Complexity:
+    Initializing the tree: O(1).
+    Query: O(log(U)), where U = 2^64 is the size of the range, so at most 64 levels.
+    Updates: O(log(U)).
+    Memory: O(k), where k is the number of keys that were set.
+
+It answers the same questions as the segment tree(see segment_tree.cpp), using the same monoids, but it's indexes are any 64 bit key.
+Every key that was never set has the monoid's identity.
+
+A segment tree over [0, 2^64) can't be allocated, and when keys arrive online(e.g, timestamps or ids), they can't be compressed to [0, k) beforehand.
+However, a node whose interval has no set key has the identity as it's value, and doesn't need to exist:
+a query reaching it can return the identity without looking at it.
+So, nodes are only created when a key in their interval is set, and a missing child stands for an interval of identities.
+
+Path compression:
+    Creating the whole path from the root to a key's leaf would take 64 nodes per key.
+    Instead, a chain of nodes with a single child is skipped: every node has either two children or none(a leaf, for a single key).
+    Each node stores it's interval, which is an aligned interval of size 2^bits: [prefix, prefix + 2^bits - 1], where prefix is a multiple of 2^bits.
+    The children of a node with interval of size 2^bits are in it's left and right halves, which are decided by bit bits-1 of the keys.
+    A child's interval may be smaller than the half it's in, as the gap is made of unset keys.
+
+    With k keys, there are k leafs and k-1 nodes with two children, so the tree has at most 2k-1 nodes, no matter how spread the keys are.
+
+Set:
+    Walking down from the root, if the key is inside the node's interval, it continues to the child on the key's side(or updates the node, if it's the key's leaf).
+    If the tree is empty, the key's leaf becomes the root.
+    If the key is outside the node's interval, a new leaf is created for it, and the node and the leaf become the children of a new node, with the smallest aligned interval containing both:
+        It's size is 2^bits, where bits-1 is the highest bit where the key and the node's prefix differ.
+    The nodes in the path are then recalculated, from the bottom up.
+
+Query:
+    Same as the recursive segment tree query: the intervals entirely inside [l,r] return their value, the ones outside it return the identity, and the others recurse on their children.
+
+Arena allocation:
+    As in the persistent segment tree(see persistent_segment_tree.cpp), nodes are taken in order from a pool and reference their children by their 32 bit index in it.
+    Indexes take half the memory of pointers and stay valid when the pool grows, and nodes are contiguous instead of scattered by separate allocations.
+
+
+Observations:
+    With up to 2^31 indexes, the tree holds up to 2^30 keys.
+
+    Keys that should be removed can be set to the identity, which keeps their nodes.
+*/
+
+//Implementation Examples:
+
+#pragma once
+
+#include "segment_tree.cpp"
+#include "persistent_segment_tree.cpp"
+
+using namespace std;
+
+//Dynamic segtree for any monoid, e.g, DynamicSegTree<ll, SumMonoid<ll>> for the sum of the values of the keys in an interval
+
+template<class T, class Monoid>
+struct DynamicSegTree {
+    struct Node {
+        T val;
+        uint64_t prefix; //the node's interval is [prefix, prefix + 2^bits - 1].
+        int bits;        //0 for leafs.
+        int left, right; //-1 for leafs.
+    };
+
+    Arena<Node> arena;
+    int root = -1;
+    long long keys = 0;
+
+    DynamicSegTree() {}
+    explicit DynamicSegTree(int expectedKeys) { arena.pool.resize(2*expectedKeys); } //allocates the pool for that many keys upfront.
+
+    long long size() const { return keys; } //number of keys that were set.
+    int nodes() const { return arena.used; }
+
+    void set(uint64_t key, T v) { root = set(root, key, v); }
+
+    T get(uint64_t key) const {
+        int node = root;
+
+        while(node != -1 && inside(key, arena[node])) {
+            const Node& curr = arena[node];
+            if(curr.bits == 0) return curr.val;
+            node = (key >> (curr.bits-1) & 1) ? curr.right : curr.left;
+        }
+
+        return Monoid::identity();
+    }
+
+    T query(uint64_t l, uint64_t r) const { return query(root, l, r); }
+
+private:
+    static bool inside(uint64_t key, const Node& node) {
+        return node.bits == 64 || (key >> node.bits) == (node.prefix >> node.bits);
+    }
+
+    static uint64_t last(const Node& node) {
+        return node.bits == 64 ? UINT64_MAX : node.prefix + ((uint64_t(1) << node.bits) - 1);
+    }
+
+    int leaf(uint64_t key, T v) {
+        keys++;
+        return arena.alloc({v, key, 0, -1, -1});
+    }
+
+    void update(int node) {
+        Node& curr = arena[node];
+        curr.val = Monoid::op(arena[curr.left].val, arena[curr.right].val);
+    }
+
+    int set(int node, uint64_t key, T v) {
+        if(node == -1) return leaf(key, v);
+
+        Node curr = arena[node]; //copied by value, as alloc may move the pool.
+
+        //The key is outside the node: both become children of a new node.
+        if(!inside(key, curr)) {
+            int bits = 64 - __builtin_clzll(key ^ curr.prefix);
+            uint64_t prefix = bits == 64 ? 0 : key >> bits << bits;
+            int keyLeaf = leaf(key, v);
+
+            bool keyRight = key >> (bits-1) & 1;
+            int parent = arena.alloc({Monoid::identity(), prefix, bits, keyRight ? node : keyLeaf, keyRight ? keyLeaf : node});
+            update(parent);
+            return parent;
+        }
+
+        if(curr.bits == 0) {
+            arena[node].val = v;
+            return node;
+        }
+
+        if(key >> (curr.bits-1) & 1) {
+            int right = set(curr.right, key, v);
+            arena[node].right = right;
+        }else {
+            int left = set(curr.left, key, v);
+            arena[node].left = left;
+        }
+
+        update(node);
+        return node;
+    }
+
+    T query(int node, uint64_t l, uint64_t r) const {
+        if(node == -1) return Monoid::identity();
+
+        const Node& curr = arena[node];
+        if(last(curr) < l || r < curr.prefix) return Monoid::identity();
+        if(l <= curr.prefix && last(curr) <= r) return curr.val;
+
+        return Monoid::op(query(curr.left, l, r), query(curr.right, l, r));
+    }
+};
@@ -0,0 +1,139 @@
+/*
+Persistent segment tree is a segment tree that keeps every previous version of itself, so queries can be made on any past state of the array.
+Time Complexity:
+    Initializing the tree: O(n).
+    Query on any version: O(logn)
+    Updates: O(logn) time and memory per new version.
+    Where n is the number of elements in the array.
+
+It answers the same questions as the segment tree(see segment_tree.cpp), using the same monoids, but query and set also take a version.
+
+Copying the whole tree on each update would cost O(n) per version.
+However, an update only changes the nodes in the path from the updated leaf to the root, which are logn+1 nodes.
+Every other node is the same in the old and new versions, so both versions can share it.
+
+Path copying:
+    To update index i on version v, the nodes in the path from v's root to leaf i are copied, and the copies are changed.
+    Each copied node keeps pointing to the original child that isn't in the path, and to the copy of the child that is.
+    The copied root is the root of the new version, while v's root still sees the old values.
+
+As nodes are no longer in the 2*i+1/2*i+2 positions of an array, each node stores the indexes of it's children.
+
+Arena allocation:
+    Nodes are never freed one by one, so instead of allocating each node separately, they're taken in order from a single pool(an arena).
+    Children are referenced by their index in the pool, which stays valid when the pool grows.
+    Nodes created after some point in time occupy a suffix of the pool, so all of them can be dropped at once by moving the end of the pool back.
+    This allows working in epochs: mark the state of the tree, create any number of versions, and drop all of them in O(1).
+
+
+Observations:
+    Epochs must be dropped in the reverse order they were marked, as a dropped epoch also drops every epoch marked after it.
+
+    Versions don't need to be linear: setting on an old version creates a new branch of history, leaving the newer versions intact.
+*/
+
+//Implementation Examples:
+
+#pragma once
+
+#include "segment_tree.cpp"
+
+using namespace std;
+
+//Pool of nodes of type Node, referenced by their indexes
+
+template<class Node>
+struct Arena {
+    vector<Node> pool;
+    int used = 0;
+
+    int alloc(const Node& node) {
+        if(used == (int)pool.size()) pool.resize(max<int>(16, 2*pool.size()));
+        pool[used] = node;
+        return used++;
+    }
+
+    Node& operator[](int i) { return pool[i]; }
+    const Node& operator[](int i) const { return pool[i]; }
+
+    int mark() const { return used; }
+    void release(int mark) { used = mark; }
+};
+
+//Persistent segtree for any monoid, e.g, PersistentSegTree<ll, SumMonoid<ll>> for the sum of an interval as of some version
+
+template<class T, class Monoid>
+struct PersistentSegTree {
+    struct Node {
+        T val;
+        int left, right; //-1 for leafs.
+    };
+
+    struct Epoch {
+        int nodes, versions;
+    };
+
+    Arena<Node> arena;
+    vector<int> roots; //roots[v] is the root of version v.
+    int n = 0;
+
+    template<class Iterator>
+    PersistentSegTree(Iterator first, Iterator last) {
+        vector<T> a(first, last);
+        n = a.size();
+        roots.push_back(n == 0 ? -1 : build(a, 0, n-1)); //an empty tree's versions have no root.
+    }
+
+    PersistentSegTree(const vector<T>& a) : PersistentSegTree(a.begin(), a.end()) {}
+
+    int size() const { return n; }
+    int versions() const { return roots.size(); }
+
+    //Returns the new version, equal to version except for index i.
+    int set(int version, int i, T v) {
+        roots.push_back(set(roots[version], 0, n-1, i, v));
+        return roots.size()-1;
+    }
+
+    T query(int version, int l, int r) const {
+        if(roots[version] == -1) return Monoid::identity();
+        return query(roots[version], 0, n-1, l, r);
+    }
+
+    Epoch mark() const { return {arena.mark(), (int)roots.size()}; }
+
+    void drop(Epoch epoch) {
+        arena.release(epoch.nodes);
+        roots.resize(epoch.versions);
+    }
+
+private:
+    int build(const vector<T>& a, int lx, int rx) {
+        if(lx == rx) return arena.alloc({a[lx], -1, -1});
+
+        int m = (lx+rx)/2;
+        int left = build(a, lx, m), right = build(a, m+1, rx);
+        return arena.alloc({Monoid::op(arena[left].val, arena[right].val), left, right});
+    }
+
+    int set(int node, int lx, int rx, int i, T v) {
+        if(lx == rx) return arena.alloc({v, -1, -1});
+
+        int m = (lx+rx)/2;
+        Node copy = arena[node]; //copied by value, as alloc may move the pool.
+
+        if(i <= m) copy.left = set(copy.left, lx, m, i, v);
+        else copy.right = set(copy.right, m+1, rx, i, v);
+
+        copy.val = Monoid::op(arena[copy.left].val, arena[copy.right].val);
+        return arena.alloc(copy);
+    }
+
+    T query(int node, int lx, int rx, int l, int r) const {
+        if(rx < l || r < lx) return Monoid::identity();
+        if(l <= lx && rx <= r) return arena[node].val;
+
+        int m = (lx+rx)/2;
+        return Monoid::op(query(arena[node].left, lx, m, l, r), query(arena[node].right, m+1, rx, l, r));
+    }
+};
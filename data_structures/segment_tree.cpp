@@ -1,5 +1,5 @@
 /*
-Segment tree is a data structure that, given a binary associative function f with neutral element:
+Segment tree is a data structure that, given a binary associative function f with neutral element(a monoid):
     Calculates the value of f in an interval [l,r].
     Updates the value of a given index i.
 
@@ -29,144 +29,346 @@ a's sum segtree:
                  3   9   13  6
                 2 1 3 6 5 8 4 2
 
-All this information is stored in a single array in the following manner:
+All this information is stored in a single array of size 2n in the following manner:
 
 a's sum segtree array indexes:
 
-                        0
-                   1          2
-                 3   4     5     6
-                7 8 9 10 11 12 13 14
+                        1
+                   2          3
+                 4   5     6     7
+                8 9 10 11 12 13 14 15
 
+The leafs, i.e, the original array, occupy the second half of the array: a[i] is stored at index n+i.
+Index 0 is unused.
 This convenient indexing discards the need for the storage of any aditional information for the tree traversal, given that, for a non-leaf node in index i:
-    The node at 2*i+1 is it's left child.
-    The node at 2*i+2 is it's right child.
+    The node at 2*i is it's left child.
+    The node at 2*i+1 is it's right child.
+    The node at i/2 is it's parent.
 
-Notice that, as every node has two childs except for leafs, a segment tree is a perfect binary tree.
-Given that, for a perfect binary tree to be possible, every level, from the root level to the leaf level, must have a power of two number of elements.
-As the original array's number of elements may not be a power of two, these remaining spots may interfere in the overall result of some node.
-This can be solved by filling the extra spots of the leaf row with the neutral element of the operation being considered.
+When n is not a power of two, the same layout still works without padding the leaf row to a power of two.
+Some nodes then combine values that are not adjacent in the original array(e.g. the last leaf and a node above the first leafs), so their values are meaningless.
+That's not a problem, as a query walking up from both borders of an interval never reaches one of those nodes before it's borders cross.
 
 Segtree's functionality is separated in three functions:
 
 Init:
-    The init function takes an array and builds it's segtree for some operation.
-        It finds the smallest power of two x bigger than the initial array and sets the segtree array size to be 2x-1.
-        For an initial array of size n, all n initial positions of the leaf's row are set equal to the initial array. *The index of the first element in the leaf row is the array size - x.
-        The remaining elements are set as the neutral element of this segtree's operation.
-        All non-leaf nodes are set to be the result of the operation of it's two children.
+    The init function takes an array(or any iterator range) and builds it's segtree for some operation.
+        All n positions of the leaf's row are set equal to the initial array.
+        All non-leaf nodes, from index n-1 down to 1, are set to be the result of the operation of it's two children.
 
 Update:
     The update function makes changes to a leaf node the segtree array and updates all it's parents, navigating through the indexes by their mentioned properties.
+
 Query:
     The query function returns the result of the operation given a specific interval [l,r] of the array.
+    It starts at the leafs of both borders and walks up the tree, one level per iteration:
+        If the left border is a right child, it's parent covers elements outside the interval, so it's value is added to the left result and the border moves one node to the right.
+        If the right border is a left child, the same is done, symmetrically, to the right result.
+    Left and right results are kept separately, so the operation doesn't need to be commutative.
 
 All three functions may be recursively or iteratively implemented.
-In the following examples, Init and Update are iterative, whilst Query is recursive.
+In the following example, all of them are iterative.
+The operation is given as a monoid: a struct with it's neutral element(identity) and the binary associative function(op).
+
+Batched queries:
+    A single query walks up the tree one level at a time, and for large trees each level is a cache miss that the query has to wait for.
+    Queries are independent, so a batch of them can walk up the tree together: each step advances every query in a group by one level.
+    Right after a query advances, it prefetches the two nodes it will read in the next step, which are then loaded while the other queries of the group advance.
+    This way, the cache misses of the whole group overlap instead of happening one after another.
+    Large batches can also be split in contiguous shards, each answered by a different thread, as queries only read the tree.
+
+Lazy propagation:
+    Updating every index of an interval [l,r] with set takes O(klogn), where k = r-l+1.
+    Instead, a range update can be stored as a pending tag on the O(logn) nodes that exactly cover [l,r], the same nodes a query would visit.
+    The node's value is updated right away, and the tag is only pushed down to it's children when some later operation needs to go through them.
+    For this to work, tags must be:
+        Applicable to a node's value knowing only the value and the number of leafs below it(e.g. adding v to a sum of len elements adds v*len).
+        Composable, so that a node can hold a single tag equivalent to all it's pending ones.
+    Affine updates x -> a*x + b cover range add(a = 1) and range assign(a = 0), and compose into affine updates again.
+    With sums, all of them can be applied. With min/max, a must not be negative, or the order of the values would flip.
+
+    Before touching a node, all tags on the path from the root to it are pushed down, and after changing it, the path is recalculated.
+    Pushing from the top needs every node in a level to have the same number of leafs, so the lazy tree pads the leaf row to a power of two with the neutral element.
+    Range updates and queries take O(logn).
 */
 
 
 
 //Implementation Examples:
 
+#pragma once
+
 #include "bits/stdc++.h"
+#include "../algorithms/instrumentation.cpp"
 
 using namespace std;
 using ll = long long;
 using pii = pair<int,int>;
 
-//Segtree for the sum of values in an interval
+//Monoids
+
+template<class T>
+struct SumMonoid {
+    static T identity() { return 0; }
+    static T op(const T& a, const T& b) { return a + b; }
+};
+
+template<class T>
+struct MinMonoid {
+    static T identity() { return numeric_limits<T>::max(); }
+    static T op(const T& a, const T& b) { return min(a, b); }
+};
+
+template<class T>
+struct MaxMonoid {
+    static T identity() { return numeric_limits<T>::lowest(); }
+    static T op(const T& a, const T& b) { return max(a, b); }
+};
+
+//Segtree for any monoid, e.g, SegTree<ll, SumMonoid<ll>> for the sum of values in an interval
 
+template<class T, class Monoid>
 struct SegTree {
-    vector<ll> seg;
-    int lr_start; //lr refers to the last row of the tree, i.e, the row composed by all it's leafs.
-    int lr_size = 1;
+    vector<T> seg;
+    int n = 0; //number of leafs, stored at seg[n..2n-1].
+
+    SegTree(int size) : seg(2*size, Monoid::identity()), n(size) {}
+
+    template<class Iterator>
+    SegTree(Iterator first, Iterator last) {
+        n = distance(first, last);
+        seg.assign(2*n, Monoid::identity());
+        copy(first, last, seg.begin() + n);
+
+        for(int i = n-1; 0 < i; i--) {
+            seg[i] = Monoid::op(seg[2*i], seg[2*i+1]);
+        }
+    }
 
-    SegTree(vector<int> &a) {
-        setSize(a.size());
+    int size() const { return n; }
 
-        lr_start = seg.size() - lr_size;
+    T get(int i) const { return seg[n + i]; }
 
-        for(int i = 0; i < a.size(); i++) {
-            seg[lr_start + i] = a[i];
+    void set(int i, T v) {
+        i = n + i;
+        seg[i] = v;
+
+        for(i /= 2; i > 0; i /= 2) {
+            seg[i] = Monoid::op(seg[2*i], seg[2*i+1]);
         }
+    }
+
+    //The Instrumentation policy counts the nodes read(see ../algorithms/instrumentation.cpp).
+    template<class Instrumentation>
+    T query(int l, int r, Instrumentation& instrumentation) const {
+        T resl = Monoid::identity(), resr = Monoid::identity();
 
-        for(int i = lr_start-1; 0 <= i; i--) {
-            seg[i] = seg[2*i+1] + seg[2*i+2];
+        for(l += n, r += n+1; l < r; l /= 2, r /= 2) {
+            instrumentation.nodeTouched((l & 1) + (r & 1));
+            if(l & 1) resl = Monoid::op(resl, seg[l++]);
+            if(r & 1) resr = Monoid::op(seg[--r], resr);
         }
+
+        return Monoid::op(resl, resr);
     }
 
-    void setSize(int array_size) {
-        while(lr_size < array_size) lr_size *= 2;
-        seg.resize(2*lr_size - 1, 0); //all positions intialized to the operation's neutral element.
+    T query(int l, int r) const {
+        NoInstrumentation none;
+        return query(l, r, none);
     }
 
-    void set(int i, int v) {
-        i = lr_start + i;
-        seg[i] = v;
+    //Answers queries[j] into out[j], interleaving groups of queries and splitting the batch among threads.
+    void queryBatch(const vector<pii>& queries, vector<T>& out, int threads = 1) const {
+        out.resize(queries.size());
+        int count = queries.size();
+        threads = max(1, min(threads, count/QUERY_GROUP));
 
-        while(i > 0) {
-            if(i % 2 == 0) i = (i-2)/2;
-            else i = (i-1)/2;
-            seg[i] = seg[2*i+1] + seg[2*i+2];
+        if(threads == 1) {
+            queryBatch(queries.data(), out.data(), count);
+            return;
         }
-    }
 
-    ll query(int l, int r, int lx = 0, int rx = -1, int i = 0) {
-        if(rx == -1) rx = lr_size-1;
+        vector<thread> workers;
+        for(int t = 0; t < threads; t++) {
+            int begin = (long long)count*t/threads, end = (long long)count*(t+1)/threads;
+            workers.emplace_back([this, &queries, &out, begin, end] {
+                queryBatch(queries.data() + begin, out.data() + begin, end - begin);
+            });
+        }
 
-        int m = (lx+rx)/2;
+        for(thread& worker : workers) worker.join();
+    }
 
-        if(rx < l || r < lx) return 0;
-        if(l <= lx && rx <= r) return seg[i];
-        return query(l, r, lx, m, 2*i+1) + query(l, r, m+1, rx, 2*i+2);
+private:
+    static constexpr int QUERY_GROUP = 16; //queries walking up the tree together.
+
+    void queryBatch(const pii* queries, T* out, int count) const {
+        int l[QUERY_GROUP], r[QUERY_GROUP];
+        T resl[QUERY_GROUP], resr[QUERY_GROUP];
+
+        for(int base = 0; base < count; base += QUERY_GROUP) {
+            int group = min(QUERY_GROUP, count - base);
+
+            for(int j = 0; j < group; j++) {
+                l[j] = queries[base+j].first + n;
+                r[j] = queries[base+j].second + n+1;
+                resl[j] = resr[j] = Monoid::identity();
+                __builtin_prefetch(&seg[l[j]]);
+                __builtin_prefetch(&seg[r[j]-1]);
+            }
+
+            for(bool active = true; active; ) {
+                active = false;
+
+                for(int j = 0; j < group; j++) {
+                    if(r[j] <= l[j]) continue;
+
+                    //Both nodes are read unconditionally, so the parity checks compile to selects instead of unpredictable branches.
+                    int lodd = l[j] & 1, rodd = r[j] & 1;
+                    T vl = seg[l[j]], vr = seg[r[j]-1];
+                    resl[j] = lodd ? Monoid::op(resl[j], vl) : resl[j];
+                    resr[j] = rodd ? Monoid::op(vr, resr[j]) : resr[j];
+                    l[j] = (l[j] + lodd)/2, r[j] = (r[j] - rodd)/2;
+
+                    if(l[j] < r[j]) {
+                        __builtin_prefetch(&seg[l[j]]);
+                        __builtin_prefetch(&seg[r[j]-1]);
+                        active = true;
+                    }
+                }
+            }
+
+            for(int j = 0; j < group; j++) {
+                out[base+j] = Monoid::op(resl[j], resr[j]);
+            }
+        }
     }
 };
 
-//Segtree for the minimum value in an interval
+//Affine range updates x -> a*x + b, for the lazy segtree
 
-struct SegTree {
-    vector<int> seg;
-    int lr_start; //lr refers to the last row of the tree, i.e, the row composed by all it's leafs.
-    int lr_size = 1;
+template<class T>
+struct Affine {
+    T a = 1, b = 0;
 
-    SegTree(vector<int> &a) {
-        setSize(a.size());
+    static Affine add(T v) { return {1, v}; }
+    static Affine assign(T v) { return {0, v}; }
+};
 
-        lr_start = seg.size() - lr_size;
+template<class T>
+struct AffineSumAction {
+    using Tag = Affine<T>;
 
-        for(int i = 0; i < a.size(); i++) {
-            seg[lr_start + i] = a[i];
-        }
+    static Tag identity() { return {1, 0}; }
+    static T apply(const Tag& f, const T& x, int len) { return f.a*x + f.b*len; }
+    static Tag compose(const Tag& f, const Tag& g) { return {f.a*g.a, f.a*g.b + f.b}; } //f after g
+};
 
-        for(int i = lr_start-1; 0 <= i; i--) {
-            seg[i] = min(seg[2*i+1], seg[2*i+2]);
+template<class T>
+struct AffineMinMaxAction { //requires a >= 0
+    using Tag = Affine<T>;
+
+    static Tag identity() { return {1, 0}; }
+    static T apply(const Tag& f, const T& x, int) { return f.a*x + f.b; }
+    static Tag compose(const Tag& f, const Tag& g) { return {f.a*g.a, f.a*g.b + f.b}; }
+};
+
+//Lazy segtree, e.g, LazySegTree<ll, SumMonoid<ll>, AffineSumAction<ll>> for range add/assign and range sum
+
+template<class T, class Monoid, class Action>
+struct LazySegTree {
+    using Tag = typename Action::Tag;
+
+    vector<T> seg;
+    vector<Tag> lazy; //pending tag of each non-leaf node.
+    int n = 0, lr_size = 1, lr_log = 0; //lr refers to the last row of the tree, padded to a power of two.
+
+    LazySegTree(int size) : LazySegTree(vector<T>(size, Monoid::identity())) {}
+
+    template<class Iterator>
+    LazySegTree(Iterator first, Iterator last) {
+        n = distance(first, last);
+        while(lr_size < n) lr_size *= 2, lr_log++;
+
+        seg.assign(2*lr_size, Monoid::identity());
+        lazy.assign(lr_size, Action::identity());
+        copy(first, last, seg.begin() + lr_size);
+
+        for(int i = lr_size-1; 0 < i; i--) {
+            update(i);
         }
     }
 
-    void setSize(int array_size) {
-        while(lr_size < array_size) lr_size *= 2;
-        seg.resize(2*lr_size - 1, INT_MAX); //all positions intialized to the operation's neutral element.
+    LazySegTree(const vector<T>& a) : LazySegTree(a.begin(), a.end()) {}
+
+    int size() const { return n; }
+
+    T get(int i) {
+        i += lr_size;
+        for(int k = lr_log; 0 < k; k--) push(i >> k);
+        return seg[i];
     }
 
-    void set(int i, int v) {
-        i = lr_start + i;
+    void set(int i, T v) {
+        i += lr_size;
+        for(int k = lr_log; 0 < k; k--) push(i >> k);
         seg[i] = v;
+        for(int k = 1; k <= lr_log; k++) update(i >> k);
+    }
+
+    T query(int l, int r) {
+        l += lr_size, r += lr_size+1;
+        pushBorders(l, r);
+
+        T resl = Monoid::identity(), resr = Monoid::identity();
 
-        while(i > 0) {
-            if(i % 2 == 0) i = (i-2)/2;
-            else i = (i-1)/2;
-            seg[i] = min(seg[2*i+1], seg[2*i+2]);
+        for(; l < r; l /= 2, r /= 2) {
+            if(l & 1) resl = Monoid::op(resl, seg[l++]);
+            if(r & 1) resr = Monoid::op(seg[--r], resr);
+        }
+
+        return Monoid::op(resl, resr);
+    }
+
+    void apply(int l, int r, const Tag& f) {
+        l += lr_size, r += lr_size+1;
+        pushBorders(l, r);
+
+        for(int lx = l, rx = r; lx < rx; lx /= 2, rx /= 2) {
+            if(lx & 1) applyAt(lx++, f);
+            if(rx & 1) applyAt(--rx, f);
+        }
+
+        for(int k = 1; k <= lr_log; k++) {
+            if(((l >> k) << k) != l) update(l >> k);
+            if(((r >> k) << k) != r) update((r-1) >> k);
         }
     }
 
-    ll query(int l, int r, int lx = 0, int rx = -1, int i = 0) {
-        if(rx == -1) rx = lr_size-1;
+    void add(int l, int r, T v) { apply(l, r, Tag::add(v)); }
+    void assign(int l, int r, T v) { apply(l, r, Tag::assign(v)); }
 
-        int m = (lx+rx)/2;
+private:
+    int len(int i) const { return lr_size >> (31 - __builtin_clz(i)); } //number of leafs below node i.
 
-        if(rx < l || r < lx) return 0;
-        if(l <= lx && rx <= r) return seg[i];
-        return min(query(l, r, lx, m, 2*i+1), query(l, r, m+1, rx, 2*i+2));
+    void update(int i) { seg[i] = Monoid::op(seg[2*i], seg[2*i+1]); }
+
+    void applyAt(int i, const Tag& f) {
+        seg[i] = Action::apply(f, seg[i], len(i));
+        if(i < lr_size) lazy[i] = Action::compose(f, lazy[i]);
+    }
+
+    void push(int i) {
+        applyAt(2*i, lazy[i]);
+        applyAt(2*i+1, lazy[i]);
+        lazy[i] = Action::identity();
     }
-};
\ No newline at end of file
+
+    //Pushes the tags of every node above the borders of [l,r), unless the border is the start of that node.
+    void pushBorders(int l, int r) {
+        for(int k = lr_log; 0 < k; k--) {
+            if(((l >> k) << k) != l) push(l >> k);
+            if(((r >> k) << k) != r) push((r-1) >> k);
+        }
+    }
+};
@@ -0,0 +1,229 @@
+/*
+Sparse table is a data structure that, given an array that never changes and an idempotent monoid f(f(x,x) = x, e.g, min, max, gcd, and, or):
+    Calculates the value of f in an interval [l,r] in O(1).
+
+Time Complexity:
+    Initializing the table: O(nlogn).
+    Query: O(1).
+    Where n is the number of elements in the array.
+
+The table stores, for every k such that 2^k <= n, the value of f over every interval of size 2^k:
+
+    table[k][i] = f(a[i], a[i+1], ..., a[i + 2^k - 1])
+
+Level 0 is the array itself, and each next level is calculated from the previous one, as an interval of size 2^k is two halves of size 2^(k-1):
+
+    table[k][i] = f(table[k-1][i], table[k-1][i + 2^(k-1)])
+
+For the array a from segment_tree.cpp and f = min:
+
+Array:          2 1 3 6 5 8 4 2
+Level 1:        1 1 3 5 5 4 2
+Level 2:        1 1 3 4 2
+Level 3:        1
+
+Query:
+    With k the largest such that 2^k <= r-l+1, the intervals [l, l+2^k-1] and [r-2^k+1, r] together cover [l,r].
+    They may overlap, which is why f must be idempotent: elements in both of them are counted twice, and f(x,x) = x.
+    The answer is f(table[k][l], table[k][r-2^k+1]): two reads, no matter the size of the interval.
+
+Unlike the segment tree(see segment_tree.cpp), which also answers updates, queries take O(1) instead of O(logn), but the array can't change.
+
+
+Block decomposition(for min/max):
+    The table takes nlogn values, which for large arrays is much more memory than the array itself.
+    When f selects one of it's arguments(min, max), the answer is an element of the array, and a query can return it's index(argmin).
+    Then, the array is split in blocks of B = 64 elements, and queries are split in 3 parts:
+        The part of [l,r] in l's block, and the part in r's block, answered inside each block.
+        The whole blocks between them, answered by a sparse table over the argmin of each block, with n/B elements.
+    The sparse table over blocks takes (n/B)log(n/B) values, so the whole structure takes O(n) memory.
+
+    Queries inside a block(bitmask trick):
+        For each position i of a block, consider the elements j <= i of the block such that a[j] < a[k] for every k in (j, i].
+        These are the elements of the stack used to build the block's Cartesian tree, after inserting i, and they're stored as a 64 bit mask(mask[i]).
+        The minimum of [l,i], with l in the same block, is the first element of that stack at position >= l:
+            Any smaller element in [l,i] would have removed it from the stack, and any element before it was removed by a smaller one in [l,i].
+        So, the answer is the lowest set bit of mask[i] after clearing the bits below l: one and, and one count trailing zeros instruction.
+        The masks are built with the stack, in O(B) per block.
+
+    Ties are broken towards the leftmost index.
+
+Parallel build:
+    Every value of a level only depends on the previous level, so each level is split among threads.
+    The loop over a level reads two contiguous ranges of the previous level and writes a contiguous range, which compilers vectorize for min/max of arithmetic types.
+    The masks of each block are independent, so blocks are split among threads as well.
+
+
+Observations:
+    For monoids that aren't idempotent(e.g, sum), the overlapping intervals count elements twice.
+    Then, a query can be split in O(logn) disjoint intervals of sizes that are powers of two, or answered with prefix sums when the operation has an inverse.
+
+    gcd, and, or aren't selections, so their queries can't use the block decomposition, and use the plain sparse table.
+*/
+
+//Implementation Examples:
+
+#pragma once
+
+#include "segment_tree.cpp"
+#include "../algorithms/threads.cpp"
+
+using namespace std;
+
+//Idempotent monoids, besides MinMonoid and MaxMonoid
+
+template<class T>
+struct GcdMonoid {
+    static T identity() { return 0; }
+    static T op(const T& a, const T& b) { return gcd(a, b); }
+};
+
+template<class T>
+struct AndMonoid {
+    static T identity() { return ~T(0); }
+    static T op(const T& a, const T& b) { return a & b; }
+};
+
+template<class T>
+struct OrMonoid {
+    static T identity() { return 0; }
+    static T op(const T& a, const T& b) { return a | b; }
+};
+
+const int SPARSE_TABLE_PARALLEL_SIZE = 1 << 16; //smaller ranges are built by one thread.
+const int SPARSE_TABLE_CHUNK = 16;
+
+//Calls f(begin, end) for contiguous ranges splitting [0,count), each on a thread(see threads.cpp), with at least SPARSE_TABLE_PARALLEL_SIZE elements per thread.
+template<class F>
+void splitAmongThreads(int count, int threads, F f) {
+    threads = max(1, min(threads, count/SPARSE_TABLE_PARALLEL_SIZE));
+    runThreads(threads, [&](int t) { f((long long)count*t/threads, (long long)count*(t+1)/threads); });
+}
+
+//Sparse table for any idempotent monoid, e.g, SparseTable<int, MinMonoid<int>>
+
+template<class T, class Monoid>
+struct SparseTable {
+    vector<vector<T>> table; //table[k][i] is the value of [i, i+2^k-1].
+    int n = 0;
+
+    template<class Iterator>
+    SparseTable(Iterator first, Iterator last, int threads = 1) {
+        n = distance(first, last);
+        table.emplace_back(first, last);
+
+        for(int k = 1; (1 << k) <= n; k++) {
+            int half = 1 << (k-1), size = n - (1 << k) + 1;
+            table.emplace_back(size);
+
+            const T* prev = table[k-1].data();
+            T* curr = table[k].data();
+            splitAmongThreads(size, threads, [=](int begin, int end) {
+                combine(prev + begin, prev + begin + half, curr + begin, end - begin);
+            });
+        }
+    }
+
+    SparseTable(const vector<T>& a, int threads = 1) : SparseTable(a.begin(), a.end(), threads) {}
+
+    int size() const { return n; }
+
+    T query(int l, int r) const {
+        int k = 31 - __builtin_clz(r-l+1);
+        return Monoid::op(table[k][l], table[k][r - (1 << k) + 1]);
+    }
+
+private:
+    //to[i] = op(left[i], right[i]). Levels don't overlap, so the loop is vectorized without checking for aliasing.
+    static void combine(const T* __restrict left, const T* __restrict right, T* __restrict to, int count) {
+        int i = 0;
+
+        //Chunks of a fixed size are vectorized even with -O2, which doesn't vectorize loops that need a scalar tail.
+        //The values are copied, as min/max of references select an address to load from.
+        for(; i + SPARSE_TABLE_CHUNK <= count; i += SPARSE_TABLE_CHUNK) {
+            for(int j = 0; j < SPARSE_TABLE_CHUNK; j++) {
+                T a = left[i+j], b = right[i+j];
+                to[i+j] = Monoid::op(a, b);
+            }
+        }
+
+        for(; i < count; i++) to[i] = Monoid::op(left[i], right[i]);
+    }
+};
+
+//Block decomposed range minimum, with O(n) memory. Compare = greater<T> for the maximum.
+
+template<class T, class Compare = less<T>>
+struct BlockRmq {
+    static const int B = 64;
+
+    vector<T> values;
+    vector<uint64_t> mask;      //mask[i], bit j: the element j of i's block is in the stack after inserting i.
+    vector<vector<int>> blocks; //blocks[k][b] is the argmin of blocks [b, b+2^k-1].
+    Compare comp;
+
+    template<class Iterator>
+    BlockRmq(Iterator first, Iterator last, int threads = 1, Compare comp = Compare()) : values(first, last), mask(values.size()), comp(comp) {
+        int n = values.size(), count = (n + B-1)/B;
+
+        splitAmongThreads(count, threads, [&](int begin, int end) {
+            for(int b = begin; b < end; b++) buildBlock(b);
+        });
+
+        blocks.emplace_back(count);
+        for(int b = 0; b < count; b++) blocks[0][b] = inBlock(b*B, min(n, b*B + B) - 1);
+
+        for(int k = 1; (1 << k) <= count; k++) {
+            int half = 1 << (k-1), size = count - (1 << k) + 1;
+            blocks.emplace_back(size);
+
+            splitAmongThreads(size, threads, [&, k, half](int begin, int end) {
+                for(int b = begin; b < end; b++) blocks[k][b] = better(blocks[k-1][b], blocks[k-1][b + half]);
+            });
+        }
+    }
+
+    BlockRmq(const vector<T>& a, int threads = 1, Compare comp = Compare()) : BlockRmq(a.begin(), a.end(), threads, comp) {}
+
+    int size() const { return values.size(); }
+
+    //Index of the minimum of [l,r], the leftmost one if there are ties.
+    int argmin(int l, int r) const {
+        int bl = l/B, br = r/B;
+        if(bl == br) return inBlock(l, r);
+
+        int best = inBlock(l, bl*B + B-1);
+        if(bl+1 < br) {
+            int k = 31 - __builtin_clz(br-1 - bl);
+            best = better(best, better(blocks[k][bl+1], blocks[k][br - (1 << k)]));
+        }
+
+        return better(best, inBlock(br*B, r));
+    }
+
+    T query(int l, int r) const { return values[argmin(l, r)]; }
+
+private:
+    //The better of indexes i < j.
+    int better(int i, int j) const { return comp(values[j], values[i]) ? j : i; }
+
+    //Argmin of [l,r], both in the same block.
+    int inBlock(int l, int r) const {
+        int start = r & ~(B-1);
+        return start + __builtin_ctzll(mask[r] & (~uint64_t(0) << (l - start)));
+    }
+
+    void buildBlock(int b) {
+        int start = b*B, end = min<int>(values.size(), start + B);
+        uint64_t stack = 0;
+
+        for(int i = start; i < end; i++) {
+            while(stack && comp(values[i], values[start + 63 - __builtin_clzll(stack)])) {
+                stack &= ~(uint64_t(1) << (63 - __builtin_clzll(stack)));
+            }
+
+            stack |= uint64_t(1) << (i - start);
+            mask[i] = stack;
+        }
+    }
+};
@@ -0,0 +1,218 @@
+/*
+Wide segment tree is a segment tree whose nodes have B children instead of two, with B chosen so that a node fills a cache line.
+Time Complexity:
+    Initializing the tree: O(n).
+    Query: O(B*log_B(n)), which in practice is O(log_B(n)) SIMD operations.
+    Updates: O(B*log_B(n)), idem.
+    Where n is the number of elements in the array.
+
+It answers the same questions as the binary segment tree(see segment_tree.cpp), with the same query/set functions.
+
+The binary tree does one memory access per level, and with 2n nodes the tree stops fitting in cache for large arrays.
+Then, every level below the cached ones is a cache miss, which dominates the running time.
+By making every node as large as a cache line(64 bytes: 16 ints or 8 long longs), each cache miss brings B useful values instead of one or two.
+The tree also gets shallower: for n = 10^8 ints, a binary tree has 27 levels, while a tree with B = 16 has 7.
+
+The tree is stored level by level:
+
+    Level 0 is the array itself, split in nodes of B consecutive elements and padded with the neutral element.
+    Value j of level k+1 is the result of the operation over node j of level k.
+    The last level has a single node.
+
+For B = 4 and the sum of array a from segment_tree.cpp:
+
+Level 1:        [12 19  0  0]
+Level 0:        [2 1 3 6] [5 8 4 2]
+
+Query:
+    At level k, with interval [l,r] in level k indexes:
+        If l and r are in the same node, the result is the operation over that node's slice [l,r], and the query ends.
+        Else, the tail of l's node is added to the left result and the head of r's node is added to the right result.
+        Every node strictly between them is a whole node, so it is represented by a single value in level k+1, in the interval [l/B + 1, r/B - 1].
+    As nodes are contiguous and aligned to a cache line, the operation over a slice of a node is done with SIMD instructions.
+    The lanes outside the slice are replaced by the neutral element, so the same code handles every slice without branches.
+
+Update:
+    Sets the element in level 0 and, for every level above it, recalculates the value of the node it's in.
+
+
+Observations:
+    The SIMD reductions are specializations for int and long long sums/minimums with B filling exactly a cache line, compiled when AVX2 is available(e.g. -mavx2 or -march=native).
+    Every other monoid falls back to a scalar loop over the slice, which is still cache friendly.
+
+    For small arrays that fit in cache, the binary tree has cheaper operations per level and might be faster.
+*/
+
+//Implementation Examples:
+
+#include "segment_tree.cpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//Operation over the slice [a,b] of a node of B values
+
+template<class T, class Monoid, int B>
+struct WideNodeReduce {
+    static T reduce(const T* node, int a, int b) {
+        T res = Monoid::identity();
+        for(int i = a; i <= b; i++) res = Monoid::op(res, node[i]);
+        return res;
+    }
+};
+
+#ifdef __AVX2__
+
+//Mask of the lanes [a,b] of a node, for lane indexes idx.
+inline __m256i laneMask32(__m256i idx, int a, int b) {
+    return _mm256_and_si256(_mm256_cmpgt_epi32(idx, _mm256_set1_epi32(a-1)), _mm256_cmpgt_epi32(_mm256_set1_epi32(b+1), idx));
+}
+
+inline __m256i laneMask64(__m256i idx, int a, int b) {
+    return _mm256_and_si256(_mm256_cmpgt_epi64(idx, _mm256_set1_epi64x(a-1)), _mm256_cmpgt_epi64(_mm256_set1_epi64x(b+1), idx));
+}
+
+template<>
+struct WideNodeReduce<int, SumMonoid<int>, 16> {
+    static int reduce(const int* node, int a, int b) {
+        __m256i lo = _mm256_load_si256((const __m256i*)node), hi = _mm256_load_si256((const __m256i*)(node + 8));
+        lo = _mm256_and_si256(lo, laneMask32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), a, b));
+        hi = _mm256_and_si256(hi, laneMask32(_mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15), a, b));
+
+        __m256i s8 = _mm256_add_epi32(lo, hi);
+        __m128i s4 = _mm_add_epi32(_mm256_castsi256_si128(s8), _mm256_extracti128_si256(s8, 1));
+        __m128i s2 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128i s1 = _mm_add_epi32(s2, _mm_shuffle_epi32(s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(s1);
+    }
+};
+
+template<>
+struct WideNodeReduce<int, MinMonoid<int>, 16> {
+    static int reduce(const int* node, int a, int b) {
+        __m256i inf = _mm256_set1_epi32(INT_MAX);
+        __m256i lo = _mm256_load_si256((const __m256i*)node), hi = _mm256_load_si256((const __m256i*)(node + 8));
+        lo = _mm256_blendv_epi8(inf, lo, laneMask32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), a, b));
+        hi = _mm256_blendv_epi8(inf, hi, laneMask32(_mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15), a, b));
+
+        __m256i m8 = _mm256_min_epi32(lo, hi);
+        __m128i m4 = _mm_min_epi32(_mm256_castsi256_si128(m8), _mm256_extracti128_si256(m8, 1));
+        __m128i m2 = _mm_min_epi32(m4, _mm_shuffle_epi32(m4, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128i m1 = _mm_min_epi32(m2, _mm_shuffle_epi32(m2, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(m1);
+    }
+};
+
+template<>
+struct WideNodeReduce<long long, SumMonoid<long long>, 8> {
+    static long long reduce(const long long* node, int a, int b) {
+        __m256i lo = _mm256_load_si256((const __m256i*)node), hi = _mm256_load_si256((const __m256i*)(node + 4));
+        lo = _mm256_and_si256(lo, laneMask64(_mm256_setr_epi64x(0, 1, 2, 3), a, b));
+        hi = _mm256_and_si256(hi, laneMask64(_mm256_setr_epi64x(4, 5, 6, 7), a, b));
+
+        __m256i s4 = _mm256_add_epi64(lo, hi);
+        __m128i s2 = _mm_add_epi64(_mm256_castsi256_si128(s4), _mm256_extracti128_si256(s4, 1));
+        return _mm_cvtsi128_si64(_mm_add_epi64(s2, _mm_unpackhi_epi64(s2, s2)));
+    }
+};
+
+template<>
+struct WideNodeReduce<long long, MinMonoid<long long>, 8> {
+    static __m256i min64(__m256i x, __m256i y) { return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(x, y)); }
+
+    static long long reduce(const long long* node, int a, int b) {
+        __m256i inf = _mm256_set1_epi64x(LLONG_MAX);
+        __m256i lo = _mm256_load_si256((const __m256i*)node), hi = _mm256_load_si256((const __m256i*)(node + 4));
+        lo = _mm256_blendv_epi8(inf, lo, laneMask64(_mm256_setr_epi64x(0, 1, 2, 3), a, b));
+        hi = _mm256_blendv_epi8(inf, hi, laneMask64(_mm256_setr_epi64x(4, 5, 6, 7), a, b));
+
+        __m256i m4 = min64(lo, hi);
+        __m256i m2 = min64(m4, _mm256_permute4x64_epi64(m4, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m256i m1 = min64(m2, _mm256_permute4x64_epi64(m2, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm256_extract_epi64(m1, 0);
+    }
+};
+
+#endif
+
+//Wide segtree for any monoid, e.g, WideSegTree<int, MinMonoid<int>> for the minimum value in an interval
+
+template<class T, class Monoid, int B = max<int>(2, 64/sizeof(T))>
+struct WideSegTree {
+    struct alignas(64) Node {
+        T v[B];
+    };
+
+    vector<vector<Node>> levels;
+    int n = 0;
+
+    WideSegTree(int size) : WideSegTree(vector<T>(size, Monoid::identity())) {}
+
+    template<class Iterator>
+    WideSegTree(Iterator first, Iterator last) {
+        n = distance(first, last);
+
+        levels.emplace_back(newLevel(n));
+        int i = 0;
+        for(Iterator it = first; it != last; it++, i++) {
+            value(0, i) = *it;
+        }
+
+        for(int count = levels.back().size(); 1 < count; count = levels.back().size()) {
+            int k = levels.size()-1;
+            levels.emplace_back(newLevel(count));
+
+            for(int j = 0; j < count; j++) {
+                value(k+1, j) = reduce(k, j, 0, B-1);
+            }
+        }
+    }
+
+    WideSegTree(const vector<T>& a) : WideSegTree(a.begin(), a.end()) {}
+
+    int size() const { return n; }
+
+    T get(int i) const { return levels[0][i/B].v[i%B]; }
+
+    void set(int i, T v) {
+        value(0, i) = v;
+
+        for(int k = 0; k+1 < (int)levels.size(); k++) {
+            i /= B;
+            value(k+1, i) = reduce(k, i, 0, B-1);
+        }
+    }
+
+    T query(int l, int r) const {
+        T resl = Monoid::identity(), resr = Monoid::identity();
+
+        for(int k = 0; l <= r; k++) {
+            if(l/B == r/B) {
+                return Monoid::op(Monoid::op(resl, reduce(k, l/B, l%B, r%B)), resr);
+            }
+
+            resl = Monoid::op(resl, reduce(k, l/B, l%B, B-1));
+            resr = Monoid::op(reduce(k, r/B, 0, r%B), resr);
+            l = l/B + 1;
+            r = r/B - 1;
+        }
+
+        return Monoid::op(resl, resr);
+    }
+
+private:
+    static vector<Node> newLevel(int count) {
+        Node empty;
+        fill(empty.v, empty.v + B, Monoid::identity());
+        return vector<Node>(max(1, (count + B-1)/B), empty);
+    }
+
+    T& value(int k, int i) { return levels[k][i/B].v[i%B]; }
+
+    T reduce(int k, int j, int a, int b) const {
+        return WideNodeReduce<T, Monoid, B>::reduce(levels[k][j].v, a, b);
+    }
+};